@@ -0,0 +1,271 @@
+#pragma once
+
+#include <array>        //for std::array
+#include <atomic>       //for std::atomic, std::memory_order
+#include <cstddef>      //for std::size_t
+#include <cstdint>      //for std::uint64_t
+#include <type_traits>  //for std::make_unsigned<T>, std::conditional<B, T, F>
+
+#include "Fraction.hpp"
+
+namespace Fraction{
+namespace detail{
+/**
+ * ATOMIC WORD STORAGE
+ *
+ * Holds numerator and denominator as one word so that both change in a single atomic step.
+ *
+ * PackedWord     - both parts fit in 64 bits, uses std::atomic<std::uint64_t>
+ * DoubleWord     - 64 bit parts on x86-64, uses lock cmpxchg16b on a 16 byte aligned pair
+ * GenericWord    - anything else, uses std::atomic of the pair (lock free only if the platform allows it)
+ */
+template <class T>
+struct PackedWord {
+    using Unsigned = typename std::make_unsigned<T>::type;
+    using Value = std::uint64_t;
+
+    std::atomic<Value> word_;
+
+    static Value pack(const T &numerator, const T &denominator) {
+        return static_cast<Value>(static_cast<Unsigned>(numerator)) | (static_cast<Value>(static_cast<Unsigned>(denominator)) << 32);
+    }
+    static T numerator(const Value &value) { return static_cast<T>(static_cast<Unsigned>(value)); }
+    static T denominator(const Value &value) { return static_cast<T>(static_cast<Unsigned>(value >> 32)); }
+
+    Value load() const { return word_.load(std::memory_order_acquire); }
+    void store(const Value &value) { word_.store(value, std::memory_order_release); }
+    bool compareExchange(Value &expected, const Value &desired) {
+        return word_.compare_exchange_strong(expected, desired, std::memory_order_acq_rel, std::memory_order_acquire);
+    }
+};
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+template <class T>
+struct DoubleWord {
+    struct alignas(16) Value {
+        std::uint64_t low;
+        std::uint64_t high;
+    };
+
+    Value word_;
+
+    static Value pack(const T &numerator, const T &denominator) {
+        return Value{static_cast<std::uint64_t>(numerator), static_cast<std::uint64_t>(denominator)};
+    }
+    static T numerator(const Value &value) { return static_cast<T>(value.low); }
+    static T denominator(const Value &value) { return static_cast<T>(value.high); }
+
+    // on failure expected receives the current value, on success memory keeps desired
+    bool compareExchange(Value &expected, const Value &desired) {
+        bool exchanged;
+        __asm__ __volatile__("lock cmpxchg16b %1"
+                             : "=@ccz"(exchanged), "+m"(word_), "+a"(expected.low), "+d"(expected.high)
+                             : "b"(desired.low), "c"(desired.high)
+                             : "memory");
+        return exchanged;
+    }
+    // there is no plain 16 byte atomic load, a failed or idempotent exchange returns the current value
+    Value load() const {
+        Value current{0, 0};
+        const_cast<DoubleWord *>(this)->compareExchange(current, current);
+        return current;
+    }
+    void store(const Value &value) {
+        Value current = load();
+        while (!compareExchange(current, value)) {
+        }
+    }
+};
+#endif
+
+template <class T>
+struct GenericWord {
+    struct Value {
+        T numerator;
+        T denominator;
+    };
+
+    std::atomic<Value> word_;
+
+    static Value pack(const T &numerator, const T &denominator) { return Value{numerator, denominator}; }
+    static T numerator(const Value &value) { return value.numerator; }
+    static T denominator(const Value &value) { return value.denominator; }
+
+    Value load() const { return word_.load(std::memory_order_acquire); }
+    void store(const Value &value) { word_.store(value, std::memory_order_release); }
+    bool compareExchange(Value &expected, const Value &desired) {
+        return word_.compare_exchange_strong(expected, desired, std::memory_order_acq_rel, std::memory_order_acquire);
+    }
+};
+
+template <class T>
+using AtomicWord = typename std::conditional<sizeof(T) <= 4, PackedWord<T>,
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+                                             typename std::conditional<sizeof(T) == 8, DoubleWord<T>, GenericWord<T>>::type
+#else
+                                             GenericWord<T>
+#endif
+                                             >::type;
+}  // namespace detail
+
+/**
+ * ATOMIC FRACTION CLASS
+ *
+ * Fraction that can be shared between threads without a mutex.
+ * Numerator and denominator are kept in one word and updated with compare and swap,
+ * so a reader never sees the numerator of one value paired with the denominator of another.
+ * Values are always stored reduced, so comparing raw words is the same as comparing values.
+ */
+template <class T>
+class AtomicFraction {
+private:
+    // members
+    detail::AtomicWord<T> word_;
+
+    // methods
+    using Value = typename detail::AtomicWord<T>::Value;
+    static Value pack(const Fraction<T> &fraction);  // packs reduced fraction into a word
+    static Fraction<T> unpack(const Value &value);   // unpacks word into fraction without reducing
+
+public:
+    // constructors
+    AtomicFraction(const Fraction<T> &fraction = Fraction<T>());  // constructs with default value of 0/1
+    AtomicFraction(const AtomicFraction &) = delete;
+    AtomicFraction &operator=(const AtomicFraction &) = delete;
+
+    // atomic access
+    Fraction<T> load() const;                                                    // returns current value
+    void store(const Fraction<T> &desired);                                      // replaces current value
+    bool compare_exchange(Fraction<T> &expected, const Fraction<T> &desired);  // replaces value if it equals expected, otherwise loads it into expected
+
+    // atomic read modify write, return the value from before the operation
+    Fraction<T> fetch_add(const Fraction<T> &other);  // adds fraction
+    Fraction<T> fetch_mul(const Fraction<T> &other);  // multiplies by fraction
+};
+
+template <class T>
+typename AtomicFraction<T>::Value AtomicFraction<T>::pack(const Fraction<T> &fraction) {
+    return detail::AtomicWord<T>::pack(fraction.numerator_, fraction.denominator_);
+}
+
+template <class T>
+Fraction<T> AtomicFraction<T>::unpack(const Value &value) {
+    return Fraction<T>(detail::AtomicWord<T>::numerator(value), detail::AtomicWord<T>::denominator(value), typename Fraction<T>::ReducedTag{});
+}
+
+template <class T>
+AtomicFraction<T>::AtomicFraction(const Fraction<T> &fraction) {
+    word_.store(pack(fraction));
+}
+
+template <class T>
+Fraction<T> AtomicFraction<T>::load() const {
+    return unpack(word_.load());
+}
+
+template <class T>
+void AtomicFraction<T>::store(const Fraction<T> &desired) {
+    word_.store(pack(desired));
+}
+
+/**
+ * COMPARE EXCHANGE
+ *
+ * Strong compare and swap.
+ * Returns true and stores desired if current value is expected,
+ * otherwise returns false and writes current value into expected.
+ */
+template <class T>
+bool AtomicFraction<T>::compare_exchange(Fraction<T> &expected, const Fraction<T> &desired) {
+    Value current = pack(expected);
+    if (word_.compareExchange(current, pack(desired)))
+        return true;
+    expected = unpack(current);
+    return false;
+}
+
+/**
+ * FETCH ADD, FETCH MUL
+ *
+ * Computes the new value from a snapshot and retries until no other thread wrote in between.
+ * Returns the value the operation was applied to.
+ */
+template <class T>
+Fraction<T> AtomicFraction<T>::fetch_add(const Fraction<T> &other) {
+    Value current = word_.load();
+    Fraction<T> previous = unpack(current);
+    while (!word_.compareExchange(current, pack(previous + other))) {
+        previous = unpack(current);
+    }
+    return previous;
+}
+
+template <class T>
+Fraction<T> AtomicFraction<T>::fetch_mul(const Fraction<T> &other) {
+    Value current = word_.load();
+    Fraction<T> previous = unpack(current);
+    while (!word_.compareExchange(current, pack(previous * other))) {
+        previous = unpack(current);
+    }
+    return previous;
+}
+
+/**
+ * SHARDED FRACTION CLASS
+ *
+ * Running sum for counters that many threads add to at once.
+ * Every thread adds into its own cache line sized shard, so adds from different threads rarely collide.
+ * load() merges all shards, which costs Shards - 1 additions, so this pays off when adds outnumber reads.
+ * Only addition is supported because products do not distribute over the shards.
+ */
+template <class T, std::size_t Shards = 16>
+class ShardedFraction {
+private:
+    static_assert(Shards > 0, "ShardedFraction needs at least one shard.");
+
+    struct alignas(64) Shard {
+        AtomicFraction<T> value;
+    };
+
+    // members
+    std::array<Shard, Shards> shards_;
+
+    // methods
+    static std::size_t shardIndex();  // returns shard owned by calling thread
+
+public:
+    // atomic access
+    void add(const Fraction<T> &other);  // adds fraction into the calling thread's shard
+    Fraction<T> load() const;            // returns sum of all shards
+    void reset();                        // sets every shard to 0/1, not atomic with respect to concurrent adds
+};
+
+template <class T, std::size_t Shards>
+std::size_t ShardedFraction<T, Shards>::shardIndex() {
+    static std::atomic<std::size_t> next_index{0};
+    thread_local const std::size_t index = next_index.fetch_add(1, std::memory_order_relaxed) % Shards;
+    return index;
+}
+
+template <class T, std::size_t Shards>
+void ShardedFraction<T, Shards>::add(const Fraction<T> &other) {
+    shards_[shardIndex()].value.fetch_add(other);
+}
+
+template <class T, std::size_t Shards>
+Fraction<T> ShardedFraction<T, Shards>::load() const {
+    Fraction<T> sum;
+    for (const Shard &shard : shards_) {
+        sum += shard.value.load();
+    }
+    return sum;
+}
+
+template <class T, std::size_t Shards>
+void ShardedFraction<T, Shards>::reset() {
+    for (Shard &shard : shards_) {
+        shard.value.store(Fraction<T>());
+    }
+}
+
+}
@@ -1,10 +1,61 @@
+#pragma once
 
 #include <limits>       //for std::numeric_limits<T>::min(), std::numeric_limits<T>::max()
 #include <numeric>      //for std::gcd, std::abs
+#include <stdexcept>    //for std::invalid_argument, std::overflow_error
 #include <string>       //for std::string
 #include <type_traits>  //for std::is_integral<T>::value, std::is_same<T, bool>::value, std::is_unsigned<T>::value
+#include <utility>      //for std::swap
+#include <vector>       //for std::vector
 
 namespace Fraction{
+template <class T>
+class Fraction;
+
+template <class T>
+class AtomicFraction;
+
+template <class Derived, class T>
+class Expression;
+
+template <class T>
+class FareySequence;
+
+template <class T>
+class CalkinWilfSequence;
+
+template <class T>
+Fraction<T> pow(const Fraction<T> &base, int exponent);  // raises fraction to integer power, negative exponents allowed
+
+template <class T>
+std::vector<Fraction<T>> powers(const Fraction<T> &base, int n);  // returns base^0, base^1, ..., base^n
+
+template <class T>
+Fraction<T> parseFraction(const char *begin, const char *end);  // parses decimal or fraction text, see FractionReader.hpp
+
+/**
+ * OPERATION TRACING
+ *
+ * Compiling with FRACTION_TRACE defined makes the arithmetic and comparison operators report
+ * every operation with its operands and result to traceRecord, see FractionTrace.hpp.
+ * Without it FRACTION_TRACE_RECORD expands to nothing and the operators are unchanged.
+ * Every translation unit of a program must agree on FRACTION_TRACE, the operators are inline
+ * templates, so mixing traced and untraced units is an ODR violation and either body may win.
+ */
+enum class TraceOperation : unsigned char { Add, Subtract, Multiply, Divide, Equal, Greater, Less };
+
+#ifdef FRACTION_TRACE
+template <class T>
+void traceRecord(TraceOperation operation, const Fraction<T> &lhs, const Fraction<T> &rhs, const Fraction<T> &result);
+template <class T>
+void traceRecord(TraceOperation operation, const Fraction<T> &lhs, const Fraction<T> &rhs, bool result);
+#define FRACTION_TRACE_RECORD(operation, lhs, rhs, result) traceRecord(TraceOperation::operation, lhs, rhs, result)
+#define FRACTION_TRACE_SAVE(name) const Fraction<T> name = *this
+#else
+#define FRACTION_TRACE_RECORD(operation, lhs, rhs, result)
+#define FRACTION_TRACE_SAVE(name)
+#endif
+
 /**
  * FRACTION CLASS
  *
@@ -18,9 +69,16 @@ private:
     T numerator_;
     T denominator_;
 
+    // tag for constructing from parts that are already known to be reduced
+    struct ReducedTag {};
+
     // methods
     void reduce();  // reduces the fraction and eliminates minus sign from denominator
 
+    Fraction(const T &numerator, const T &denominator, ReducedTag);  // constructs fraction without checks or reduction
+
+    static T checkedMultiply(const T &lhs, const T &rhs);  // multiplies and throws std::overflow_error on overflow
+
 public:
     // constructors
     Fraction(const T &numerator = 0, const T &denominator = 1);  // constructs fraction with default args of 0/1
@@ -104,6 +162,24 @@ public:
     friend bool operator>=(const T &lhs, const Fraction<T> &rhs) { return Fraction<T>(lhs) >= rhs; }
     friend bool operator<(const T &lhs, const Fraction<T> &rhs) { return Fraction<T>(lhs) < rhs; }
     friend bool operator<=(const T &lhs, const Fraction<T> &rhs) { return Fraction<T>(lhs) <= rhs; }
+
+    // powers
+    friend Fraction<T> pow<>(const Fraction<T> &base, int exponent);
+    friend std::vector<Fraction<T>> powers<>(const Fraction<T> &base, int n);
+
+    // atomic wrapper reads and writes raw parts
+    friend class AtomicFraction<T>;
+
+    // expression templates build the final result without reducing again
+    template <class Derived, class U>
+    friend class Expression;
+
+    // generators only produce fractions that are reduced by construction
+    friend class FareySequence<T>;
+    friend class CalkinWilfSequence<T>;
+
+    // decimals are reduced while parsing by cancelling factors 2 and 5
+    friend Fraction<T> parseFraction<T>(const char *begin, const char *end);
 };
 
 /**
@@ -178,6 +254,39 @@ Fraction<T>::Fraction(const T &numerator, const T &denominator) : numerator_(num
         throw std::invalid_argument("Denominator cannot be zero.");
     reduce();
 }
+/**
+ * REDUCED CONSTRUCTOR
+ *
+ * Takes numerator and denominator as they are.
+ * Caller guarantees that denominator is positive and that the parts are coprime,
+ * so neither the zero check nor reduce() is needed.
+ */
+template <typename T>
+Fraction<T>::Fraction(const T &numerator, const T &denominator, ReducedTag) : numerator_(numerator), denominator_(denominator) {}
+
+/**
+ * CHECKED MULTIPLY
+ *
+ * Returns lhs * rhs.
+ * Throws std::overflow_error if the product does not fit in T.
+ * Divides the limits by one factor instead of multiplying, which also covers min * -1.
+ */
+template <typename T>
+T Fraction<T>::checkedMultiply(const T &lhs, const T &rhs) {
+    constexpr T max = std::numeric_limits<T>::max();
+    constexpr T min = std::numeric_limits<T>::min();
+    bool overflow;
+    if (lhs == 0 || rhs == 0)
+        overflow = false;
+    else if (lhs > 0)
+        overflow = rhs > 0 ? lhs > max / rhs : rhs < min / lhs;
+    else
+        overflow = rhs > 0 ? lhs < min / rhs : rhs < max / lhs;
+    if (overflow)
+        throw std::overflow_error("Fraction multiplication overflow.");
+    return lhs * rhs;
+}
+
 /**
  * GETTERS
  *
@@ -210,24 +319,32 @@ std::string Fraction<T>::toString() const {
 
 template <class T>
 Fraction<T> Fraction<T>::operator+(const Fraction<T> &other) const {
-    return Fraction(numerator_ * other.denominator_ + denominator_ * other.numerator_, denominator_ * other.denominator_);
+    Fraction<T> result(numerator_ * other.denominator_ + denominator_ * other.numerator_, denominator_ * other.denominator_);
+    FRACTION_TRACE_RECORD(Add, *this, other, result);
+    return result;
 }
 
 template <class T>
 Fraction<T> Fraction<T>::operator-(const Fraction<T> &other) const {
-    return Fraction(numerator_ * other.denominator_ - denominator_ * other.numerator_, denominator_ * other.denominator_);
+    Fraction<T> result(numerator_ * other.denominator_ - denominator_ * other.numerator_, denominator_ * other.denominator_);
+    FRACTION_TRACE_RECORD(Subtract, *this, other, result);
+    return result;
 }
 
 template <class T>
 Fraction<T> Fraction<T>::operator*(const Fraction<T> &other) const {
-    return Fraction(numerator_ * other.numerator_, denominator_ * other.denominator_);
+    Fraction<T> result(numerator_ * other.numerator_, denominator_ * other.denominator_);
+    FRACTION_TRACE_RECORD(Multiply, *this, other, result);
+    return result;
 }
 
 template <class T>
 Fraction<T> Fraction<T>::operator/(const Fraction<T> &other) const {
     if (other.numerator_ == 0)
         throw std::invalid_argument("Cannot divide by a fraction with a numerator of zero.");
-    return Fraction(numerator_ * other.denominator_, denominator_ * other.numerator_);
+    Fraction<T> result(numerator_ * other.denominator_, denominator_ * other.numerator_);
+    FRACTION_TRACE_RECORD(Divide, *this, other, result);
+    return result;
 }
 
 template <class T>
@@ -278,25 +395,31 @@ Fraction<T> Fraction<T>::operator--(int) {
 
 template <class T>
 Fraction<T> &Fraction<T>::operator+=(const Fraction<T> &other) {
+    FRACTION_TRACE_SAVE(before);
     numerator_ = numerator_ * other.denominator_ + other.numerator_ * denominator_;
     denominator_ = denominator_ * other.denominator_;
     reduce();
+    FRACTION_TRACE_RECORD(Add, before, other, *this);
     return *this;
 }
 
 template <class T>
 Fraction<T> &Fraction<T>::operator-=(const Fraction<T> &other) {
+    FRACTION_TRACE_SAVE(before);
     numerator_ = numerator_ * other.denominator_ - other.numerator_ * denominator_;
     denominator_ = denominator_ * other.denominator_;
     reduce();
+    FRACTION_TRACE_RECORD(Subtract, before, other, *this);
     return *this;
 }
 
 template <class T>
 Fraction<T> &Fraction<T>::operator*=(const Fraction<T> &other) {
+    FRACTION_TRACE_SAVE(before);
     numerator_ = numerator_ * other.numerator_;
     denominator_ = denominator_ * other.denominator_;
     reduce();
+    FRACTION_TRACE_RECORD(Multiply, before, other, *this);
     return *this;
 }
 
@@ -305,9 +428,11 @@ Fraction<T> &Fraction<T>::operator/=(const Fraction<T> &other) {
     if (other.numerator_ == 0) {
         throw std::invalid_argument("Cannot divide by a fraction with a numerator of zero.");
     }
+    FRACTION_TRACE_SAVE(before);
     numerator_ = numerator_ * other.denominator_;
     denominator_ = denominator_ * other.numerator_;
     reduce();
+    FRACTION_TRACE_RECORD(Divide, before, other, *this);
     return *this;
 }
 
@@ -337,7 +462,9 @@ Fraction<T> &Fraction<T>::operator/=(const T &rhs) {
 
 template <class T>
 bool Fraction<T>::operator==(const Fraction<T> &other) const {
-    return numerator_ * other.denominator_ == denominator_ * other.numerator_;
+    bool result = numerator_ * other.denominator_ == denominator_ * other.numerator_;
+    FRACTION_TRACE_RECORD(Equal, *this, other, result);
+    return result;
 }
 
 template <class T>
@@ -347,12 +474,16 @@ bool Fraction<T>::operator!=(const Fraction<T> &other) const {
 
 template <class T>
 bool Fraction<T>::operator>(const Fraction<T> &other) const {
-    return numerator_ * other.denominator_ > denominator_ * other.numerator_;
+    bool result = numerator_ * other.denominator_ > denominator_ * other.numerator_;
+    FRACTION_TRACE_RECORD(Greater, *this, other, result);
+    return result;
 }
 
 template <class T>
 bool Fraction<T>::operator<(const Fraction<T> &other) const {
-    return numerator_ * other.denominator_ < denominator_ * other.numerator_;
+    bool result = numerator_ * other.denominator_ < denominator_ * other.numerator_;
+    FRACTION_TRACE_RECORD(Less, *this, other, result);
+    return result;
 }
 
 template <class T>
@@ -425,4 +556,80 @@ bool operator<=(const T &lhs, const Fraction<T> &rhs) {
     return Fraction<T>(lhs) <= rhs;
 }
 
+/**
+ * POW - RAISES FRACTION TO AN INTEGER POWER
+ *
+ * If a/b is reduced then a^n/b^n is reduced as well,
+ * so the result is built with exponentiation by squaring and never calls gcd.
+ * For negative exponents the fraction is inverted first, moving the sign to the numerator.
+ * Base is only squared when a higher exponent bit still needs it,
+ * so an overflow_error is thrown only if the result itself does not fit in T.
+ * Raising zero to a negative power throws invalid_argument.
+ */
+template <class T>
+Fraction<T> pow(const Fraction<T> &base, int exponent) {
+    using Tag = typename Fraction<T>::ReducedTag;
+    T numerator = base.numerator_;
+    T denominator = base.denominator_;
+    if (exponent < 0) {
+        if (numerator == 0)
+            throw std::invalid_argument("Cannot raise a fraction with a numerator of zero to a negative power.");
+        std::swap(numerator, denominator);
+        if (denominator < 0) {
+            if (denominator == std::numeric_limits<T>::min())
+                throw std::overflow_error("Fraction power overflow.");
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+    }
+    // magnitude of exponent, safe for std::numeric_limits<int>::min()
+    unsigned int remaining = exponent < 0 ? 0u - static_cast<unsigned int>(exponent) : static_cast<unsigned int>(exponent);
+
+    T result_numerator = 1;
+    T result_denominator = 1;
+    while (remaining != 0) {
+        if (remaining & 1u) {
+            result_numerator = Fraction<T>::checkedMultiply(result_numerator, numerator);
+            result_denominator = Fraction<T>::checkedMultiply(result_denominator, denominator);
+        }
+        remaining >>= 1;
+        if (remaining != 0) {
+            numerator = Fraction<T>::checkedMultiply(numerator, numerator);
+            denominator = Fraction<T>::checkedMultiply(denominator, denominator);
+        }
+    }
+    return Fraction<T>(result_numerator, result_denominator, Tag{});
+}
+
+/**
+ * POWERS - RETURNS ALL POWERS OF BASE FROM 0 TO N
+ *
+ * Returns vector {base^0, base^1, ..., base^n} of size n + 1,
+ * meant for evaluating polynomials.
+ * Each power is the previous one multiplied by base without reduction,
+ * which is exact because powers of a reduced fraction stay reduced.
+ * Throws invalid_argument for negative n and overflow_error if base^n does not fit in T.
+ */
+template <class T>
+std::vector<Fraction<T>> powers(const Fraction<T> &base, int n) {
+    using Tag = typename Fraction<T>::ReducedTag;
+    if (n < 0)
+        throw std::invalid_argument("Number of powers cannot be negative.");
+    std::vector<Fraction<T>> result;
+    result.reserve(static_cast<std::size_t>(n) + 1);
+    T numerator = 1;
+    T denominator = 1;
+    result.push_back(Fraction<T>(numerator, denominator, Tag{}));
+    for (int i = 0; i < n; ++i) {
+        numerator = Fraction<T>::checkedMultiply(numerator, base.numerator_);
+        denominator = Fraction<T>::checkedMultiply(denominator, base.denominator_);
+        result.push_back(Fraction<T>(numerator, denominator, Tag{}));
+    }
+    return result;
 }
+
+}
+
+#ifdef FRACTION_TRACE
+#include "FractionTrace.hpp"
+#endif
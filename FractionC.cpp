@@ -0,0 +1,142 @@
+#define FRACTION_BUILDING_LIBRARY
+#include "FractionC.h"
+
+#include "FractionExpression.hpp"
+
+namespace {
+using Fraction::detail::Wide;
+using Fraction::detail::WideFraction;
+
+/**
+ * BATCH HELPERS
+ *
+ * Shared implementation of the int32 and int64 entry points.
+ * Arithmetic reuses the wide intermediates of the expression templates,
+ * so every element costs one gcd and never throws across the C boundary.
+ */
+template <class T>
+bool anyNull(const T *pointer) {
+    return pointer == nullptr;
+}
+
+template <class T, class... Rest>
+bool anyNull(const T *pointer, const Rest *...rest) {
+    return pointer == nullptr || anyNull(rest...);
+}
+
+template <class Operation, class T>
+fraction_status binaryBatch(const T *a_numerators, const T *a_denominators, const T *b_numerators, const T *b_denominators, T *out_numerators,
+                            T *out_denominators, size_t count) {
+    if (count != 0 && anyNull(a_numerators, a_denominators, b_numerators, b_denominators, out_numerators, out_denominators))
+        return FRACTION_NULL_POINTER;
+    for (size_t i = 0; i < count; ++i) {
+        if (a_denominators[i] == 0 || b_denominators[i] == 0)
+            return FRACTION_ZERO_DENOMINATOR;
+        WideFraction<Wide<T>> result;
+        if (!Fraction::detail::combine<Operation>(WideFraction<Wide<T>>{a_numerators[i], a_denominators[i]},
+                                                  WideFraction<Wide<T>>{b_numerators[i], b_denominators[i]}, result))
+            return FRACTION_OVERFLOW;
+        T numerator;
+        T denominator;
+        if (!Fraction::detail::narrowReduced(result, numerator, denominator))
+            return FRACTION_OVERFLOW;
+        out_numerators[i] = numerator;
+        out_denominators[i] = denominator;
+    }
+    return FRACTION_OK;
+}
+
+// products of two T never overflow the wide type, so comparison needs no reduction
+template <class T>
+fraction_status compareBatch(const T *a_numerators, const T *a_denominators, const T *b_numerators, const T *b_denominators, int32_t *out,
+                             size_t count) {
+    if (count != 0 && anyNull(a_numerators, a_denominators, b_numerators, b_denominators, out))
+        return FRACTION_NULL_POINTER;
+    for (size_t i = 0; i < count; ++i) {
+        if (a_denominators[i] == 0 || b_denominators[i] == 0)
+            return FRACTION_ZERO_DENOMINATOR;
+        Wide<T> lhs = static_cast<Wide<T>>(a_numerators[i]) * b_denominators[i];
+        Wide<T> rhs = static_cast<Wide<T>>(b_numerators[i]) * a_denominators[i];
+        int32_t order = (lhs > rhs) - (lhs < rhs);
+        out[i] = (a_denominators[i] < 0) != (b_denominators[i] < 0) ? -order : order;
+    }
+    return FRACTION_OK;
+}
+
+template <class T>
+fraction_status reduceBatch(T *numerators, T *denominators, size_t count) {
+    if (count != 0 && anyNull(numerators, denominators))
+        return FRACTION_NULL_POINTER;
+    for (size_t i = 0; i < count; ++i) {
+        if (denominators[i] == 0)
+            return FRACTION_ZERO_DENOMINATOR;
+        if (!Fraction::detail::narrowReduced(WideFraction<Wide<T>>{numerators[i], denominators[i]}, numerators[i], denominators[i]))
+            return FRACTION_OVERFLOW;
+    }
+    return FRACTION_OK;
+}
+
+template <class T>
+fraction_status toDoubleBatch(const T *numerators, const T *denominators, double *out, size_t count) {
+    if (count != 0 && anyNull(numerators, denominators, out))
+        return FRACTION_NULL_POINTER;
+    for (size_t i = 0; i < count; ++i) {
+        if (denominators[i] == 0)
+            return FRACTION_ZERO_DENOMINATOR;
+        out[i] = static_cast<double>(numerators[i]) / static_cast<double>(denominators[i]);
+    }
+    return FRACTION_OK;
+}
+}  // namespace
+
+extern "C" {
+int32_t fraction_abi_version(void) {
+    return FRACTION_ABI_VERSION;
+}
+
+fraction_status fraction_i32_add(const int32_t *a_numerators, const int32_t *a_denominators, const int32_t *b_numerators, const int32_t *b_denominators,
+                                 int32_t *out_numerators, int32_t *out_denominators, size_t count) {
+    return binaryBatch<Fraction::detail::Add>(a_numerators, a_denominators, b_numerators, b_denominators, out_numerators, out_denominators, count);
+}
+
+fraction_status fraction_i32_mul(const int32_t *a_numerators, const int32_t *a_denominators, const int32_t *b_numerators, const int32_t *b_denominators,
+                                 int32_t *out_numerators, int32_t *out_denominators, size_t count) {
+    return binaryBatch<Fraction::detail::Multiply>(a_numerators, a_denominators, b_numerators, b_denominators, out_numerators, out_denominators, count);
+}
+
+fraction_status fraction_i32_compare(const int32_t *a_numerators, const int32_t *a_denominators, const int32_t *b_numerators, const int32_t *b_denominators,
+                                     int32_t *out, size_t count) {
+    return compareBatch(a_numerators, a_denominators, b_numerators, b_denominators, out, count);
+}
+
+fraction_status fraction_i32_reduce(int32_t *numerators, int32_t *denominators, size_t count) {
+    return reduceBatch(numerators, denominators, count);
+}
+
+fraction_status fraction_i32_to_double(const int32_t *numerators, const int32_t *denominators, double *out, size_t count) {
+    return toDoubleBatch(numerators, denominators, out, count);
+}
+
+fraction_status fraction_i64_add(const int64_t *a_numerators, const int64_t *a_denominators, const int64_t *b_numerators, const int64_t *b_denominators,
+                                 int64_t *out_numerators, int64_t *out_denominators, size_t count) {
+    return binaryBatch<Fraction::detail::Add>(a_numerators, a_denominators, b_numerators, b_denominators, out_numerators, out_denominators, count);
+}
+
+fraction_status fraction_i64_mul(const int64_t *a_numerators, const int64_t *a_denominators, const int64_t *b_numerators, const int64_t *b_denominators,
+                                 int64_t *out_numerators, int64_t *out_denominators, size_t count) {
+    return binaryBatch<Fraction::detail::Multiply>(a_numerators, a_denominators, b_numerators, b_denominators, out_numerators, out_denominators, count);
+}
+
+fraction_status fraction_i64_compare(const int64_t *a_numerators, const int64_t *a_denominators, const int64_t *b_numerators, const int64_t *b_denominators,
+                                     int32_t *out, size_t count) {
+    return compareBatch(a_numerators, a_denominators, b_numerators, b_denominators, out, count);
+}
+
+fraction_status fraction_i64_reduce(int64_t *numerators, int64_t *denominators, size_t count) {
+    return reduceBatch(numerators, denominators, count);
+}
+
+fraction_status fraction_i64_to_double(const int64_t *numerators, const int64_t *denominators, double *out, size_t count) {
+    return toDoubleBatch(numerators, denominators, out, count);
+}
+}
@@ -0,0 +1,83 @@
+#ifndef FRACTION_C_H
+#define FRACTION_C_H
+
+#include <stddef.h>  //for size_t
+#include <stdint.h>  //for int32_t, int64_t
+
+/**
+ * FRACTION C ABI
+ *
+ * Stable C interface to fraction arithmetic for bindings in other languages,
+ * exported from libfraction.so, built from FractionC.cpp:
+ *
+ * c++ -std=c++17 -O2 -shared -fPIC -fvisibility=hidden FractionC.cpp -o libfraction.so
+ *
+ * FractionC.cpp defines FRACTION_BUILDING_LIBRARY, so on Windows the library exports the functions
+ * and consumers including this header import them.
+ *
+ * Every function works on whole arrays so that one call across the FFI boundary covers many fractions.
+ * Fractions are passed as two caller owned arrays, one of numerators and one of denominators,
+ * which are read and written in place without copying.
+ * Inputs do not have to be reduced, outputs are always reduced with a positive denominator.
+ * Output arrays may be the same as input arrays.
+ *
+ * Functions return FRACTION_OK or the error of the first failing element,
+ * elements before it are already written, elements after it are left untouched.
+ */
+#if defined(_WIN32) && defined(FRACTION_BUILDING_LIBRARY)
+#define FRACTION_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define FRACTION_API __declspec(dllimport)
+#else
+#define FRACTION_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// status codes
+typedef enum {
+    FRACTION_OK = 0,
+    FRACTION_ZERO_DENOMINATOR = 1,  // an input denominator is zero
+    FRACTION_OVERFLOW = 2,          // a reduced result does not fit in the element type
+    FRACTION_NULL_POINTER = 3       // an array is NULL while count is not zero
+} fraction_status;
+
+FRACTION_API int32_t fraction_abi_version(void);  // returns FRACTION_ABI_VERSION the library was built with
+#define FRACTION_ABI_VERSION 1
+
+/**
+ * BATCH FUNCTIONS
+ *
+ * For i in [0, count):
+ *
+ * add       - out[i] = a[i] + b[i]
+ * mul       - out[i] = a[i] * b[i]
+ * compare   - out[i] = -1, 0 or 1 as a[i] is less than, equal to or greater than b[i]
+ * reduce    - reduces numerator[i] / denominator[i] in place
+ * to_double - out[i] = double approximation of a[i]
+ */
+FRACTION_API fraction_status fraction_i32_add(const int32_t *a_numerators, const int32_t *a_denominators, const int32_t *b_numerators,
+                                              const int32_t *b_denominators, int32_t *out_numerators, int32_t *out_denominators, size_t count);
+FRACTION_API fraction_status fraction_i32_mul(const int32_t *a_numerators, const int32_t *a_denominators, const int32_t *b_numerators,
+                                              const int32_t *b_denominators, int32_t *out_numerators, int32_t *out_denominators, size_t count);
+FRACTION_API fraction_status fraction_i32_compare(const int32_t *a_numerators, const int32_t *a_denominators, const int32_t *b_numerators,
+                                                  const int32_t *b_denominators, int32_t *out, size_t count);
+FRACTION_API fraction_status fraction_i32_reduce(int32_t *numerators, int32_t *denominators, size_t count);
+FRACTION_API fraction_status fraction_i32_to_double(const int32_t *numerators, const int32_t *denominators, double *out, size_t count);
+
+FRACTION_API fraction_status fraction_i64_add(const int64_t *a_numerators, const int64_t *a_denominators, const int64_t *b_numerators,
+                                              const int64_t *b_denominators, int64_t *out_numerators, int64_t *out_denominators, size_t count);
+FRACTION_API fraction_status fraction_i64_mul(const int64_t *a_numerators, const int64_t *a_denominators, const int64_t *b_numerators,
+                                              const int64_t *b_denominators, int64_t *out_numerators, int64_t *out_denominators, size_t count);
+FRACTION_API fraction_status fraction_i64_compare(const int64_t *a_numerators, const int64_t *a_denominators, const int64_t *b_numerators,
+                                                  const int64_t *b_denominators, int32_t *out, size_t count);
+FRACTION_API fraction_status fraction_i64_reduce(int64_t *numerators, int64_t *denominators, size_t count);
+FRACTION_API fraction_status fraction_i64_to_double(const int64_t *numerators, const int64_t *denominators, double *out, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>  //for std::max
+#include <cmath>      //for std::fabs
+
+#include "Fraction.hpp"
+#include "FractionExpression.hpp"
+
+namespace Fraction{
+/**
+ * COMPARISON POLICIES
+ *
+ * compare(lhs, rhs) returns -1, 0 or 1 as lhs is less than, equal to or greater than rhs.
+ *
+ * ExactComparison    - cross multiplies in the wide type, so unlike the operators it never overflows
+ * FilteredComparison - decides from double approximations when they are far enough apart,
+ *                      falls back to ExactComparison only for close calls
+ *
+ * Pick one per call site with compare<Policy>(lhs, rhs) or the Less / Greater comparators,
+ * the operators on Fraction stay as they are.
+ * ExactComparison is the default, on x86-64 one wide multiply per side is at least as cheap as
+ * converting and bounding in double, even with cached approximations.
+ * FilteredComparison is meant for targets where the wide type is emulated in software.
+ */
+struct ExactComparison {
+    template <class T>
+    static int compare(const Fraction<T> &lhs, const Fraction<T> &rhs);
+};
+
+struct FilteredComparison {
+    template <class T>
+    static int compare(const Fraction<T> &lhs, const Fraction<T> &rhs);
+
+    // same as above with approximations the caller already holds, which must equal toDouble()
+    template <class T>
+    static int compare(const Fraction<T> &lhs, double lhs_approximation, const Fraction<T> &rhs, double rhs_approximation);
+};
+
+template <class T>
+int ExactComparison::compare(const Fraction<T> &lhs, const Fraction<T> &rhs) {
+    using W = detail::Wide<T>;
+    W left = static_cast<W>(lhs.getNumerator()) * rhs.getDenominator();
+    W right = static_cast<W>(rhs.getNumerator()) * lhs.getDenominator();
+    return (left > right) - (left < right);
+}
+
+/**
+ * FILTERED COMPARE
+ *
+ * Compares the cross products n1 * d2 and n2 * d1 in double, so no division is needed.
+ * Each side rounds two conversions and one product, so with unit roundoff u = 2^-53 it is within 3u
+ * (plus higher order terms) of the exact product, relatively, and so is toDouble() for the overload taking approximations.
+ * Two sides further apart than 16u * max(|left|, |right|) therefore order the exact values the same way,
+ * the margin also covers rounding of the subtraction itself.
+ * Products of two 64 bit integers stay far below the double range, and integers never round to subnormals.
+ */
+template <class T>
+int FilteredComparison::compare(const Fraction<T> &lhs, const Fraction<T> &rhs) {
+    double left = static_cast<double>(lhs.getNumerator()) * static_cast<double>(rhs.getDenominator());
+    double right = static_cast<double>(rhs.getNumerator()) * static_cast<double>(lhs.getDenominator());
+    double difference = left - right;
+    double bound = std::max(std::fabs(left), std::fabs(right)) * 0x1p-49;
+    if (std::fabs(difference) > bound)
+        return (difference > 0) - (difference < 0);
+    return ExactComparison::compare(lhs, rhs);
+}
+
+template <class T>
+int FilteredComparison::compare(const Fraction<T> &lhs, double lhs_approximation, const Fraction<T> &rhs, double rhs_approximation) {
+    double difference = lhs_approximation - rhs_approximation;
+    double bound = std::max(std::fabs(lhs_approximation), std::fabs(rhs_approximation)) * 0x1p-49;
+    if (std::fabs(difference) > bound)
+        return (difference > 0) - (difference < 0);
+    return ExactComparison::compare(lhs, rhs);
+}
+
+template <class Policy = ExactComparison, class T>
+int compare(const Fraction<T> &lhs, const Fraction<T> &rhs) {
+    return Policy::compare(lhs, rhs);
+}
+
+/**
+ * COMPARATORS
+ *
+ * Function objects for std::sort, std::lower_bound, std::merge and the like.
+ */
+template <class Policy = ExactComparison>
+struct Less {
+    template <class T>
+    bool operator()(const Fraction<T> &lhs, const Fraction<T> &rhs) const { return Policy::compare(lhs, rhs) < 0; }
+};
+
+template <class Policy = ExactComparison>
+struct LessEqual {
+    template <class T>
+    bool operator()(const Fraction<T> &lhs, const Fraction<T> &rhs) const { return Policy::compare(lhs, rhs) <= 0; }
+};
+
+template <class Policy = ExactComparison>
+struct Greater {
+    template <class T>
+    bool operator()(const Fraction<T> &lhs, const Fraction<T> &rhs) const { return Policy::compare(lhs, rhs) > 0; }
+};
+
+template <class Policy = ExactComparison>
+struct GreaterEqual {
+    template <class T>
+    bool operator()(const Fraction<T> &lhs, const Fraction<T> &rhs) const { return Policy::compare(lhs, rhs) >= 0; }
+};
+
+}
@@ -0,0 +1,342 @@
+#pragma once
+
+#include <cstdint>      //for std::int64_t
+#include <limits>       //for std::numeric_limits<T>::min(), std::numeric_limits<T>::max()
+#include <stdexcept>    //for std::invalid_argument, std::overflow_error
+#include <type_traits>  //for std::conditional<B, T, F>, std::enable_if<B, T>, std::is_integral<T>, std::true_type, std::false_type
+
+#include "Fraction.hpp"
+
+namespace Fraction{
+namespace detail{
+/**
+ * WIDE TYPES
+ *
+ * Intermediate results of an expression are kept unreduced in a type twice as wide as T,
+ * so a product of two fractions never overflows before the final reduction.
+ */
+__extension__ typedef __int128 Int128;
+
+template <class T>
+using Wide = typename std::conditional<sizeof(T) <= 4, std::int64_t, Int128>::type;
+
+template <class W>
+struct WideFraction {
+    W numerator;
+    W denominator;  // never zero, sign is fixed only after the final reduction
+};
+
+template <class W>
+W wideGcd(W a, W b) {
+    if (a < 0)
+        a = -a;
+    if (b < 0)
+        b = -b;
+    while (b != 0) {
+        W rest = a % b;
+        a = b;
+        b = rest;
+    }
+    return a;
+}
+
+// divides a and b by their gcd
+template <class W>
+void wideCancel(W &a, W &b) {
+    W common_divisor = wideGcd(a, b);
+    if (common_divisor > 1) {
+        a /= common_divisor;
+        b /= common_divisor;
+    }
+}
+
+/**
+ * OPERATIONS
+ *
+ * Each operation tries the plain wide formula first.
+ * If that overflows W, cancel() removes common factors from the operands and the formula is tried once more,
+ * if it still overflows an overflow_error is thrown.
+ * Addition reduces each operand, multiplication and division cancel crosswise.
+ */
+struct Add {
+    template <class W>
+    static void cancel(WideFraction<W> &lhs, WideFraction<W> &rhs) {
+        wideCancel(lhs.numerator, lhs.denominator);
+        wideCancel(rhs.numerator, rhs.denominator);
+    }
+    template <class W>
+    static bool apply(const WideFraction<W> &lhs, const WideFraction<W> &rhs, WideFraction<W> &result) {
+        W left, right;
+        return !__builtin_mul_overflow(lhs.numerator, rhs.denominator, &left) && !__builtin_mul_overflow(rhs.numerator, lhs.denominator, &right) &&
+               !__builtin_add_overflow(left, right, &result.numerator) && !__builtin_mul_overflow(lhs.denominator, rhs.denominator, &result.denominator);
+    }
+};
+
+struct Subtract : Add {
+    template <class W>
+    static bool apply(const WideFraction<W> &lhs, const WideFraction<W> &rhs, WideFraction<W> &result) {
+        W left, right;
+        return !__builtin_mul_overflow(lhs.numerator, rhs.denominator, &left) && !__builtin_mul_overflow(rhs.numerator, lhs.denominator, &right) &&
+               !__builtin_sub_overflow(left, right, &result.numerator) && !__builtin_mul_overflow(lhs.denominator, rhs.denominator, &result.denominator);
+    }
+};
+
+struct Multiply {
+    template <class W>
+    static void cancel(WideFraction<W> &lhs, WideFraction<W> &rhs) {
+        wideCancel(lhs.numerator, rhs.denominator);
+        wideCancel(rhs.numerator, lhs.denominator);
+    }
+    template <class W>
+    static bool apply(const WideFraction<W> &lhs, const WideFraction<W> &rhs, WideFraction<W> &result) {
+        return !__builtin_mul_overflow(lhs.numerator, rhs.numerator, &result.numerator) &&
+               !__builtin_mul_overflow(lhs.denominator, rhs.denominator, &result.denominator);
+    }
+};
+
+struct Divide {
+    template <class W>
+    static void cancel(WideFraction<W> &lhs, WideFraction<W> &rhs) {
+        wideCancel(lhs.numerator, rhs.numerator);
+        wideCancel(lhs.denominator, rhs.denominator);
+    }
+    template <class W>
+    static bool apply(const WideFraction<W> &lhs, const WideFraction<W> &rhs, WideFraction<W> &result) {
+        if (rhs.numerator == 0)
+            throw std::invalid_argument("Cannot divide by a fraction with a numerator of zero.");
+        return !__builtin_mul_overflow(lhs.numerator, rhs.denominator, &result.numerator) &&
+               !__builtin_mul_overflow(lhs.denominator, rhs.numerator, &result.denominator);
+    }
+};
+
+// applies Operation, cancelling common factors first if needed, returns false if the result still overflows W
+template <class Operation, class W>
+bool combine(WideFraction<W> lhs, WideFraction<W> rhs, WideFraction<W> &result) {
+    if (Operation::apply(lhs, rhs, result))
+        return true;
+    Operation::cancel(lhs, rhs);
+    return Operation::apply(lhs, rhs, result);
+}
+
+// reduces, moves the minus sign to the numerator and narrows to T, returns false if the result does not fit in T
+template <class T, class W>
+bool narrowReduced(WideFraction<W> fraction, T &numerator, T &denominator) {
+    wideCancel(fraction.numerator, fraction.denominator);
+    if (fraction.denominator < 0) {
+        fraction.numerator = -fraction.numerator;
+        fraction.denominator = -fraction.denominator;
+    }
+    if (fraction.numerator < std::numeric_limits<T>::min() || fraction.numerator > std::numeric_limits<T>::max() ||
+        fraction.denominator > std::numeric_limits<T>::max())
+        return false;
+    numerator = static_cast<T>(fraction.numerator);
+    denominator = static_cast<T>(fraction.denominator);
+    return true;
+}
+}  // namespace detail
+
+/**
+ * EXPRESSION CLASS
+ *
+ * Base of every lazy fraction expression, Derived must provide evaluateWide().
+ * Expressions hold their operands by value, so they stay valid after the operands go out of scope.
+ * Converting an expression to Fraction<T> evaluates the whole tree in the wide type
+ * and reduces only once at the end.
+ */
+template <class Derived, class T>
+class Expression {
+public:
+    using value_type = T;
+    using wide_type = detail::Wide<T>;
+
+    // evaluation
+    Fraction<T> evaluate() const;  // evaluates tree and returns reduced fraction
+    operator Fraction<T>() const;  // same as evaluate, allows Fraction<T> f = expression
+    double toDouble() const;       // returns double approximation of the result
+};
+
+/**
+ * FRACTION LEAF
+ *
+ * Expression holding a single fraction, made with lazy(fraction).
+ */
+template <class T>
+class FractionLeaf : public Expression<FractionLeaf<T>, T> {
+private:
+    Fraction<T> value_;
+
+public:
+    explicit FractionLeaf(const Fraction<T> &value) : value_(value) {}
+    detail::WideFraction<detail::Wide<T>> evaluateWide() const { return {value_.getNumerator(), value_.getDenominator()}; }
+};
+
+/**
+ * INTEGER LEAF
+ *
+ * Expression holding an integerlike value, created when an integer is used as an operand.
+ */
+template <class T>
+class IntegerLeaf : public Expression<IntegerLeaf<T>, T> {
+private:
+    T value_;
+
+public:
+    explicit IntegerLeaf(const T &value) : value_(value) {}
+    detail::WideFraction<detail::Wide<T>> evaluateWide() const { return {value_, 1}; }
+};
+
+/**
+ * BINARY EXPRESSION
+ *
+ * Node applying Operation to two subexpressions.
+ */
+template <class Operation, class Left, class Right>
+class BinaryExpression : public Expression<BinaryExpression<Operation, Left, Right>, typename Left::value_type> {
+private:
+    Left lhs_;
+    Right rhs_;
+
+public:
+    BinaryExpression(const Left &lhs, const Right &rhs) : lhs_(lhs), rhs_(rhs) {}
+    detail::WideFraction<detail::Wide<typename Left::value_type>> evaluateWide() const;
+};
+
+template <class Operation, class Left, class Right>
+detail::WideFraction<detail::Wide<typename Left::value_type>> BinaryExpression<Operation, Left, Right>::evaluateWide() const {
+    detail::WideFraction<detail::Wide<typename Left::value_type>> result;
+    if (detail::combine<Operation>(lhs_.evaluateWide(), rhs_.evaluateWide(), result))
+        return result;
+    throw std::overflow_error("Fraction expression overflow.");
+}
+
+/**
+ * EVALUATE - EVALUATES THE EXPRESSION TREE
+ *
+ * Runs the single gcd of the whole expression, moves the minus sign to the numerator
+ * and narrows the result back to T.
+ * Throws overflow_error if the reduced result does not fit in T.
+ */
+template <class Derived, class T>
+Fraction<T> Expression<Derived, T>::evaluate() const {
+    T numerator;
+    T denominator;
+    if (!detail::narrowReduced(static_cast<const Derived &>(*this).evaluateWide(), numerator, denominator))
+        throw std::overflow_error("Fraction expression result does not fit in the fraction type.");
+    return Fraction<T>(numerator, denominator, typename Fraction<T>::ReducedTag{});
+}
+
+template <class Derived, class T>
+Expression<Derived, T>::operator Fraction<T>() const {
+    return evaluate();
+}
+
+template <class Derived, class T>
+double Expression<Derived, T>::toDouble() const {
+    return evaluate().toDouble();
+}
+
+/**
+ * LAZY - STARTS AN EXPRESSION
+ *
+ * Plain operators on fractions stay eager, lazy() marks where fusing begins:
+ *
+ * Fraction<long> result = lazy(a) + b * lazy(c) - d;
+ *
+ * Any operator with at least one expression operand builds a node instead of a fraction.
+ */
+template <class T>
+FractionLeaf<T> lazy(const Fraction<T> &fraction) {
+    return FractionLeaf<T>(fraction);
+}
+
+namespace detail{
+template <class E>
+struct IsExpression {
+    template <class Derived, class T>
+    static std::true_type test(const Expression<Derived, T> *);
+    static std::false_type test(...);
+    static constexpr bool value = decltype(test(static_cast<const E *>(nullptr)))::value;
+};
+
+// turns an operand of an expression over T into an expression
+template <class T, class Operand, class Enable = void>
+struct ToExpression;
+
+template <class T, class Operand>
+struct ToExpression<T, Operand, typename std::enable_if<IsExpression<Operand>::value>::type> {
+    using type = Operand;
+    static const Operand &convert(const Operand &operand) { return operand; }
+};
+
+template <class T>
+struct ToExpression<T, Fraction<T>> {
+    using type = FractionLeaf<T>;
+    static FractionLeaf<T> convert(const Fraction<T> &operand) { return FractionLeaf<T>(operand); }
+};
+
+template <class T, class Operand>
+struct ToExpression<T, Operand, typename std::enable_if<std::is_integral<Operand>::value>::type> {
+    using type = IntegerLeaf<T>;
+    static IntegerLeaf<T> convert(const Operand &operand) { return IntegerLeaf<T>(static_cast<T>(operand)); }
+};
+
+// value type of whichever operand is an expression
+template <class Left, class Right, class Enable = void>
+struct ExpressionValue {
+    using type = typename Right::value_type;
+};
+
+template <class Left, class Right>
+struct ExpressionValue<Left, Right, typename std::enable_if<IsExpression<Left>::value>::type> {
+    using type = typename Left::value_type;
+};
+
+// node type for an operator, only defined when at least one operand is an expression
+template <bool HasExpression, class Operation, class Left, class Right>
+struct ExpressionNode {};
+
+template <class Operation, class Left, class Right>
+struct ExpressionNode<true, Operation, Left, Right> {
+    using T = typename ExpressionValue<Left, Right>::type;
+    using type = BinaryExpression<Operation, typename ToExpression<T, Left>::type, typename ToExpression<T, Right>::type>;
+};
+
+template <class Operation, class Left, class Right>
+using ExpressionResult = typename ExpressionNode<IsExpression<Left>::value || IsExpression<Right>::value, Operation, Left, Right>::type;
+
+template <class Operation, class Left, class Right>
+ExpressionResult<Operation, Left, Right> makeExpression(const Left &lhs, const Right &rhs) {
+    using T = typename ExpressionValue<Left, Right>::type;
+    return ExpressionResult<Operation, Left, Right>(ToExpression<T, Left>::convert(lhs), ToExpression<T, Right>::convert(rhs));
+}
+}  // namespace detail
+
+/**
+ * BASIC MATHEMATICAL OPERATORS ON EXPRESSIONS
+ *
+ * return new expression node for:
+ *
+ * expression [ + - * / ] expression, fraction or integerlike value
+ * fraction or integerlike value [ + - * / ] expression
+ */
+template <class Left, class Right>
+detail::ExpressionResult<detail::Add, Left, Right> operator+(const Left &lhs, const Right &rhs) {
+    return detail::makeExpression<detail::Add>(lhs, rhs);
+}
+
+template <class Left, class Right>
+detail::ExpressionResult<detail::Subtract, Left, Right> operator-(const Left &lhs, const Right &rhs) {
+    return detail::makeExpression<detail::Subtract>(lhs, rhs);
+}
+
+template <class Left, class Right>
+detail::ExpressionResult<detail::Multiply, Left, Right> operator*(const Left &lhs, const Right &rhs) {
+    return detail::makeExpression<detail::Multiply>(lhs, rhs);
+}
+
+template <class Left, class Right>
+detail::ExpressionResult<detail::Divide, Left, Right> operator/(const Left &lhs, const Right &rhs) {
+    return detail::makeExpression<detail::Divide>(lhs, rhs);
+}
+
+}
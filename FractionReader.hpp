@@ -0,0 +1,420 @@
+#pragma once
+
+#include <algorithm>     //for std::max
+#include <cerrno>        //for errno
+#include <cstddef>       //for std::size_t
+#include <cstring>       //for std::memchr
+#include <exception>     //for std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <stdexcept>     //for std::invalid_argument, std::overflow_error
+#include <string>        //for std::string, std::to_string
+#include <system_error>  //for std::system_error, std::generic_category
+#include <thread>        //for std::thread
+#include <vector>        //for std::vector
+
+#include <fcntl.h>     //for open
+#include <sys/mman.h>  //for mmap, munmap, madvise
+#include <sys/stat.h>  //for fstat
+#include <unistd.h>    //for close
+
+#if defined(__SSE2__)
+#include <emmintrin.h>  //for _mm_loadu_si128, _mm_cmpeq_epi8, _mm_movemask_epi8
+#endif
+
+#include "Fraction.hpp"
+
+namespace Fraction{
+/**
+ * PARSE FRACTION - PARSES TEXT EXACTLY INTO A FRACTION
+ *
+ * Accepts, with optional surrounding spaces:
+ *
+ * integers              "-12"
+ * decimals              "12.375", ".5", "-3."
+ * scientific notation   "1.2e-3", "5E+2"
+ * fractions             "-3/4"
+ *
+ * Decimals are read as mantissa * 10^exponent in integers, never through double.
+ * Trailing zeros of the digits only move the exponent, and factors 2 and 5 of the mantissa cancel
+ * against a negative exponent, so any value that fits in T is read without overflow
+ * and the result needs no gcd.
+ * Throws invalid_argument for malformed text and overflow_error if the value does not fit in T.
+ */
+template <class T>
+Fraction<T> parseFraction(const char *begin, const char *end);
+
+template <class T>
+Fraction<T> parseFraction(const std::string &text) {
+    return parseFraction<T>(text.data(), text.data() + text.size());
+}
+
+/**
+ * CSV OPTIONS
+ *
+ * delimiter   - field separator
+ * header      - first line holds column names instead of values
+ * threads     - number of chunks parsed in parallel, 0 picks std::thread::hardware_concurrency
+ * chunk_bytes - smallest chunk worth its own thread
+ */
+struct CsvOptions {
+    char delimiter = ',';
+    bool header = false;
+    unsigned int threads = 0;
+    std::size_t chunk_bytes = 1 << 20;
+};
+
+/**
+ * FRACTION COLUMNS CLASS
+ *
+ * Columnar table of fractions, one vector per column, as produced by readCsv.
+ */
+template <class T>
+class FractionColumns {
+private:
+    // members
+    std::vector<std::string> names_;
+    std::vector<std::vector<Fraction<T>>> columns_;
+
+    template <class U>
+    friend FractionColumns<U> readCsv(const std::string &path, const CsvOptions &options);
+
+public:
+    // getters
+    std::size_t columnCount() const { return columns_.size(); }                                     // returns number of columns
+    std::size_t rowCount() const { return columns_.empty() ? 0 : columns_.front().size(); }          // returns number of rows
+    const std::vector<std::string> &names() const { return names_; }                                 // returns header names, empty without header
+    const std::vector<Fraction<T>> &column(std::size_t index) const { return columns_.at(index); }  // returns column at index
+};
+
+/**
+ * READ CSV - LOADS A CSV FILE OF NUMBERS INTO COLUMNS
+ *
+ * The file is memory mapped and split at line breaks into chunks that are parsed on separate threads,
+ * then the chunks are appended in file order.
+ * Every field is parsed with parseFraction, quoting is not supported.
+ * Lines may end with \n or \r\n, empty lines are skipped.
+ * Throws system_error if the file cannot be mapped, invalid_argument with the byte offset of the
+ * offending line if a field is malformed or a row has the wrong number of fields,
+ * overflow_error with the byte offset of the field if a value does not fit in T.
+ */
+template <class T>
+FractionColumns<T> readCsv(const std::string &path, const CsvOptions &options = CsvOptions());
+
+namespace detail{
+template <class T>
+bool accumulateDigit(T &value, int digit, bool negative) {
+    return !__builtin_mul_overflow(value, 10, &value) && (negative ? !__builtin_sub_overflow(value, digit, &value) : !__builtin_add_overflow(value, digit, &value));
+}
+
+template <class T>
+T parseInteger(const char *&current, const char *end) {
+    bool negative = false;
+    if (current != end && (*current == '-' || *current == '+'))
+        negative = *current++ == '-';
+    if (current == end || *current < '0' || *current > '9')
+        throw std::invalid_argument("Expected digits in fraction text.");
+    T value = 0;
+    for (; current != end && *current >= '0' && *current <= '9'; ++current) {
+        if (!accumulateDigit(value, *current - '0', negative))
+            throw std::overflow_error("Fraction text does not fit in the fraction type.");
+    }
+    return value;
+}
+
+inline void trim(const char *&begin, const char *&end) {
+    while (begin != end && (*begin == ' ' || *begin == '\t'))
+        ++begin;
+    while (begin != end && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+        --end;
+}
+
+/**
+ * FIND SEPARATOR
+ *
+ * Returns pointer to the first delimiter or line break in [current, end), or end.
+ * With SSE2 it compares 16 bytes at a time, which is where most of the ingestion time goes.
+ */
+inline const char *findSeparator(const char *current, const char *end, char delimiter) {
+#if defined(__SSE2__)
+    const __m128i delimiters = _mm_set1_epi8(delimiter);
+    const __m128i newlines = _mm_set1_epi8('\n');
+    for (; end - current >= 16; current += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(current));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, delimiters), _mm_cmpeq_epi8(block, newlines)));
+        if (mask != 0)
+            return current + __builtin_ctz(static_cast<unsigned int>(mask));
+    }
+#endif
+    while (current != end && *current != delimiter && *current != '\n')
+        ++current;
+    return current;
+}
+
+/**
+ * MAPPED FILE CLASS
+ *
+ * Read only memory mapping of a whole file, unmapped on destruction.
+ */
+class MappedFile {
+private:
+    const char *data_ = nullptr;
+    std::size_t size_ = 0;
+
+public:
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *begin() const { return data_; }
+    const char *end() const { return data_ + size_; }
+    std::size_t size() const { return size_; }
+};
+
+inline MappedFile::MappedFile(const std::string &path) {
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        throw std::system_error(errno, std::generic_category(), "Cannot open " + path);
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0) {
+        int error = errno;
+        ::close(descriptor);
+        throw std::system_error(error, std::generic_category(), "Cannot stat " + path);
+    }
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (size_ != 0) {
+        void *mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED) {
+            int error = errno;
+            ::close(descriptor);
+            throw std::system_error(error, std::generic_category(), "Cannot map " + path);
+        }
+        ::madvise(mapping, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char *>(mapping);
+    }
+    ::close(descriptor);
+}
+
+inline MappedFile::~MappedFile() {
+    if (data_ != nullptr)
+        ::munmap(const_cast<char *>(data_), size_);
+}
+
+// returns pointer past the line break ending the line that contains position, or end
+inline const char *nextLine(const char *position, const char *end) {
+    const void *line_break = std::memchr(position, '\n', static_cast<std::size_t>(end - position));
+    return line_break != nullptr ? static_cast<const char *>(line_break) + 1 : end;
+}
+
+// returns pointer to the line break ending the line that starts at line, or end
+inline const char *lineEnd(const char *line, const char *end) {
+    const void *line_break = std::memchr(line, '\n', static_cast<std::size_t>(end - line));
+    return line_break != nullptr ? static_cast<const char *>(line_break) : end;
+}
+
+// returns true if the line holds nothing but spaces
+inline bool blank(const char *begin, const char *end) {
+    trim(begin, end);
+    return begin == end;
+}
+
+// parses whole lines in [begin, end) into columns, offset is the position of begin in the file for error messages
+template <class T>
+void parseChunk(const char *begin, const char *end, std::size_t offset, char delimiter, std::vector<std::vector<Fraction<T>>> &columns) {
+    for (const char *line = begin; line != end;) {
+        const char *line_end = lineEnd(line, end);
+        if (!blank(line, line_end)) {
+            std::size_t column = 0;
+            for (const char *field_begin = line;; ++column) {
+                const char *field_end = findSeparator(field_begin, line_end, delimiter);
+                if (column == columns.size())
+                    throw std::invalid_argument("Too many fields in CSV line at byte " + std::to_string(offset + (line - begin)) + ".");
+                try {
+                    columns[column].push_back(parseFraction<T>(field_begin, field_end));
+                } catch (const std::invalid_argument &) {
+                    throw std::invalid_argument("Malformed CSV field at byte " + std::to_string(offset + (field_begin - begin)) + ".");
+                } catch (const std::overflow_error &) {
+                    throw std::overflow_error("CSV field does not fit in the fraction type at byte " + std::to_string(offset + (field_begin - begin)) + ".");
+                }
+                if (field_end == line_end)
+                    break;
+                field_begin = field_end + 1;
+            }
+            if (column + 1 != columns.size())
+                throw std::invalid_argument("Too few fields in CSV line at byte " + std::to_string(offset + (line - begin)) + ".");
+        }
+        line = line_end == end ? end : line_end + 1;
+    }
+}
+}  // namespace detail
+
+template <class T>
+Fraction<T> parseFraction(const char *begin, const char *end) {
+    detail::trim(begin, end);
+    const char *current = begin;
+    const char *slash = current;
+    while (slash != end && *slash != '/')
+        ++slash;
+    if (slash != end) {
+        T numerator = detail::parseInteger<T>(current, slash);
+        if (current != slash)
+            throw std::invalid_argument("Malformed fraction text.");
+        ++current;
+        T denominator = detail::parseInteger<T>(current, end);
+        if (current != end)
+            throw std::invalid_argument("Malformed fraction text.");
+        return Fraction<T>(numerator, denominator);
+    }
+
+    bool negative = false;
+    if (current != end && (*current == '-' || *current == '+'))
+        negative = *current++ == '-';
+    // value is mantissa * 10^(pending_zeros - fraction_digits + explicit exponent)
+    T mantissa = 0;
+    long pending_zeros = 0;  // trailing zeros of the digits not yet multiplied into mantissa
+    long fraction_digits = 0;
+    bool digits = false;
+    auto digit = [&](int value) {
+        if (value == 0) {
+            ++pending_zeros;
+            return;
+        }
+        for (; pending_zeros > 0; --pending_zeros) {
+            if (!detail::accumulateDigit(mantissa, 0, negative))
+                throw std::overflow_error("Fraction text does not fit in the fraction type.");
+        }
+        if (!detail::accumulateDigit(mantissa, value, negative))
+            throw std::overflow_error("Fraction text does not fit in the fraction type.");
+    };
+    for (; current != end && *current >= '0' && *current <= '9'; ++current, digits = true)
+        digit(*current - '0');
+    if (current != end && *current == '.') {
+        for (++current; current != end && *current >= '0' && *current <= '9'; ++current, ++fraction_digits, digits = true)
+            digit(*current - '0');
+    }
+    if (!digits)
+        throw std::invalid_argument("Malformed fraction text.");
+    long exponent = pending_zeros - fraction_digits;
+    if (current != end && (*current == 'e' || *current == 'E')) {
+        ++current;
+        if (mantissa == 0) {
+            // any exponent of zero is zero, so it is only checked for digits
+            if (current != end && (*current == '-' || *current == '+'))
+                ++current;
+            if (current == end || *current < '0' || *current > '9')
+                throw std::invalid_argument("Expected digits in fraction text.");
+            while (current != end && *current >= '0' && *current <= '9')
+                ++current;
+        } else {
+            long explicit_exponent = detail::parseInteger<long>(current, end);
+            if (__builtin_add_overflow(exponent, explicit_exponent, &exponent))
+                throw std::overflow_error("Fraction text does not fit in the fraction type.");
+        }
+    }
+    if (current != end)
+        throw std::invalid_argument("Malformed fraction text.");
+    if (mantissa == 0)
+        return Fraction<T>(0);
+
+    for (; exponent > 0; --exponent) {
+        if (__builtin_mul_overflow(mantissa, 10, &mantissa))
+            throw std::overflow_error("Fraction text does not fit in the fraction type.");
+    }
+    // 10^-exponent = 2^-exponent * 5^-exponent, factors shared with mantissa are cancelled before they can overflow
+    long twos = -exponent;
+    long fives = -exponent;
+    for (; twos > 0 && mantissa % 2 == 0; --twos)
+        mantissa /= 2;
+    for (; fives > 0 && mantissa % 5 == 0; --fives)
+        mantissa /= 5;
+    T denominator = 1;
+    for (; twos > 0; --twos) {
+        if (__builtin_mul_overflow(denominator, 2, &denominator))
+            throw std::overflow_error("Fraction text does not fit in the fraction type.");
+    }
+    for (; fives > 0; --fives) {
+        if (__builtin_mul_overflow(denominator, 5, &denominator))
+            throw std::overflow_error("Fraction text does not fit in the fraction type.");
+    }
+    // mantissa keeps a factor 2 or 5 only if the denominator has none left, so the result is already reduced
+    return Fraction<T>(mantissa, denominator, typename Fraction<T>::ReducedTag{});
+}
+
+template <class T>
+FractionColumns<T> readCsv(const std::string &path, const CsvOptions &options) {
+    detail::MappedFile file(path);
+    FractionColumns<T> result;
+    const char *data = file.begin();
+    const char *end = file.end();
+
+    // the first non empty line fixes the number of columns
+    const char *first = data;
+    const char *first_end = first;
+    for (; first != end; first = detail::nextLine(first_end, end)) {
+        first_end = detail::lineEnd(first, end);
+        if (!detail::blank(first, first_end))
+            break;
+    }
+    if (first == end)
+        return result;
+    std::size_t column_count = 1;
+    for (const char *position = first; position != first_end; ++position)
+        column_count += *position == options.delimiter;
+    result.columns_.resize(column_count);
+    if (options.header) {
+        for (const char *field_begin = first;;) {
+            const char *field_end = detail::findSeparator(field_begin, first_end, options.delimiter);
+            const char *name_begin = field_begin;
+            const char *name_end = field_end;
+            detail::trim(name_begin, name_end);
+            result.names_.emplace_back(name_begin, name_end);
+            if (field_end == first_end)
+                break;
+            field_begin = field_end + 1;
+        }
+        first = detail::nextLine(first_end, end);
+    }
+
+    // chunk boundaries fall right after line breaks
+    std::size_t remaining = static_cast<std::size_t>(end - first);
+    std::size_t chunks = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+    if (chunks == 0)
+        chunks = 1;
+    if (options.chunk_bytes != 0 && remaining / options.chunk_bytes < chunks)
+        chunks = remaining / options.chunk_bytes + 1;
+    std::vector<const char *> boundaries{first};
+    for (std::size_t chunk = 1; chunk < chunks; ++chunk)
+        boundaries.push_back(std::max(boundaries.back(), detail::nextLine(first + remaining / chunks * chunk, end)));
+    boundaries.push_back(end);
+
+    std::vector<std::vector<std::vector<Fraction<T>>>> parts(chunks, std::vector<std::vector<Fraction<T>>>(column_count));
+    std::vector<std::exception_ptr> errors(chunks);
+    auto parse = [&](std::size_t chunk) {
+        try {
+            detail::parseChunk(boundaries[chunk], boundaries[chunk + 1], static_cast<std::size_t>(boundaries[chunk] - data), options.delimiter, parts[chunk]);
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t chunk = 1; chunk < chunks; ++chunk)
+        threads.emplace_back(parse, chunk);
+    parse(0);
+    for (std::thread &thread : threads)
+        thread.join();
+    for (const std::exception_ptr &error : errors) {
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    for (std::size_t column = 0; column < column_count; ++column) {
+        std::size_t rows = 0;
+        for (const auto &part : parts)
+            rows += part[column].size();
+        result.columns_[column].reserve(rows);
+        for (const auto &part : parts)
+            result.columns_[column].insert(result.columns_[column].end(), part[column].begin(), part[column].end());
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,65 @@
+/**
+ * FRACTION REPLAY
+ *
+ * Replays traces written by TraceRecorder against the current build and reports
+ * throughput, latency percentiles and results that differ from the recorded ones.
+ *
+ * c++ -std=c++17 -O2 FractionReplay.cpp -o FractionReplay
+ * ./FractionReplay trace.frtr [more.frtr ...]
+ *
+ * Exits with 1 if any trace has mismatches, 2 if a trace cannot be read.
+ */
+#include <cstdio>     //for std::printf, std::fprintf
+#include <exception>  //for std::exception
+#include <string>     //for std::string
+
+#include "FractionTrace.hpp"
+
+namespace {
+template <class T>
+Fraction::TraceReplayReport replayFile(const std::string &path) {
+    return Fraction::replayTrace(Fraction::readTrace<T>(path));
+}
+
+Fraction::TraceReplayReport replayFile(const std::string &path, std::size_t width) {
+    switch (width) {
+        case sizeof(signed char):
+            return replayFile<signed char>(path);
+        case sizeof(short):
+            return replayFile<short>(path);
+        case sizeof(int):
+            return replayFile<int>(path);
+        case sizeof(long long):
+            return replayFile<long long>(path);
+    }
+    throw std::runtime_error("Trace " + path + " uses an unsupported fraction width.");
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s trace [trace ...]\n", argv[0]);
+        return 2;
+    }
+    int status = 0;
+    for (int i = 1; i < argc; ++i) {
+        try {
+            Fraction::TraceReplayReport report = replayFile(argv[i], Fraction::traceWidth(argv[i]));
+            std::printf("%s\n", argv[i]);
+            std::printf("  operations     %zu\n", report.operations);
+            std::printf("  ops/sec        %.0f\n", report.operations_per_second);
+            std::printf("  latency ns     p50 %.0f  p90 %.0f  p99 %.0f  max %.0f\n", report.latency_p50_ns, report.latency_p90_ns, report.latency_p99_ns,
+                        report.latency_max_ns);
+            std::printf("  mismatches     %zu", report.mismatches);
+            for (std::size_t index : report.first_mismatches)
+                std::printf(" #%zu", index);
+            std::printf("\n");
+            if (report.mismatches != 0 && status == 0)
+                status = 1;
+        } catch (const std::exception &error) {
+            std::fprintf(stderr, "%s\n", error.what());
+            status = 2;
+        }
+    }
+    return status;
+}
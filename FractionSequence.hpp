@@ -0,0 +1,377 @@
+#pragma once
+
+#include <algorithm>    //for std::min
+#include <cstddef>      //for std::size_t
+#include <cstdint>      //for std::uint64_t
+#include <iterator>     //for std::input_iterator_tag
+#include <limits>       //for std::numeric_limits<T>::max()
+#include <stdexcept>    //for std::invalid_argument, std::overflow_error
+#include <vector>       //for std::vector
+
+#include "Fraction.hpp"
+#include "FractionExpression.hpp"
+
+namespace Fraction{
+/**
+ * FAREY SEQUENCE CLASS
+ *
+ * Range over the Farey sequence F_N, every reduced fraction in [0, 1] with denominator at most N, in increasing order.
+ * Consecutive terms a/b < c/d determine the next one as (k * c - a) / (k * d - b) with k = (N + b) / d,
+ * so each step costs one division and the terms are reduced without ever calling gcd.
+ *
+ * The whole sequence is [0/1, 1/1], a subrange [lower, upper) lets threads share the enumeration,
+ * partition() splits F_N into such subranges.
+ */
+template <class T>
+class FareySequence {
+private:
+    // members
+    T order_;
+    T lower_numerator_;
+    T lower_denominator_;
+    T next_numerator_;    // term following lower in F_N
+    T next_denominator_;
+    T upper_numerator_;
+    T upper_denominator_;
+    bool include_upper_;
+
+public:
+    class iterator {
+    private:
+        T order_;
+        T numerator_;
+        T denominator_;
+        T next_numerator_;
+        T next_denominator_;
+        T upper_numerator_;
+        T upper_denominator_;
+        bool include_upper_;
+        bool done_;
+
+        friend class FareySequence<T>;
+        bool atUpper() const { return numerator_ == upper_numerator_ && denominator_ == upper_denominator_; }
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Fraction<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Fraction<T>;
+
+        Fraction<T> operator*() const { return Fraction<T>(numerator_, denominator_, typename Fraction<T>::ReducedTag{}); }
+        iterator &operator++();
+        iterator operator++(int);
+        bool operator==(const iterator &other) const;
+        bool operator!=(const iterator &other) const { return !(*this == other); }
+    };
+
+    // constructors
+    explicit FareySequence(const T &order);  // whole F_N, 0/1 to 1/1 inclusive
+    FareySequence(const T &order, const Fraction<T> &lower, const Fraction<T> &upper, bool include_upper = false);  // terms of F_N in [lower, upper)
+
+    // range
+    iterator begin() const;
+    iterator end() const;
+
+    static std::vector<FareySequence<T>> partition(const T &order, std::size_t parts);  // splits F_N into parts consecutive subranges
+};
+
+/**
+ * CONSTRUCTORS
+ *
+ * Order must be positive and at most half of the maximum of T, so k * d never overflows.
+ * Bounds must be terms of F_N, that is reduced with denominator at most N, and 0 <= lower <= upper <= 1.
+ * The successor of lower is found once with the extended Euclidean algorithm,
+ * after that the range is walked with the next term recurrence.
+ */
+template <class T>
+FareySequence<T>::FareySequence(const T &order) : FareySequence(order, Fraction<T>(0), Fraction<T>(1), true) {}
+
+template <class T>
+FareySequence<T>::FareySequence(const T &order, const Fraction<T> &lower, const Fraction<T> &upper, bool include_upper)
+    : order_(order),
+      lower_numerator_(lower.getNumerator()),
+      lower_denominator_(lower.getDenominator()),
+      upper_numerator_(upper.getNumerator()),
+      upper_denominator_(upper.getDenominator()),
+      include_upper_(include_upper) {
+    if (order < 1 || order > std::numeric_limits<T>::max() / 2)
+        throw std::invalid_argument("Farey sequence order must be positive and at most half of the type maximum.");
+    if (lower_denominator_ > order || upper_denominator_ > order)
+        throw std::invalid_argument("Farey sequence bounds must have denominators not greater than the order.");
+    // compared in the wide type, the operators on Fraction overflow once the order passes sqrt of the maximum of T
+    using W = detail::Wide<T>;
+    if (lower_numerator_ < 0 || upper_numerator_ > upper_denominator_ ||
+        static_cast<W>(lower_numerator_) * upper_denominator_ > static_cast<W>(upper_numerator_) * lower_denominator_)
+        throw std::invalid_argument("Farey sequence bounds must satisfy 0 <= lower <= upper <= 1.");
+
+    // next term c/d satisfies lower_denominator * c - lower_numerator * d = 1 with the largest d <= order
+    W a = lower_numerator_, b = lower_denominator_;
+    W old_remainder = a, remainder = b, old_coefficient = 1, coefficient = 0;
+    while (remainder != 0) {
+        W quotient = old_remainder / remainder;
+        W next_remainder = old_remainder - quotient * remainder;
+        W next_coefficient = old_coefficient - quotient * coefficient;
+        old_remainder = remainder;
+        remainder = next_remainder;
+        old_coefficient = coefficient;
+        coefficient = next_coefficient;
+    }
+    // a * old_coefficient = 1 (mod b), so d0 = -old_coefficient (mod b) solves a * d0 = -1 (mod b)
+    W d = ((-old_coefficient) % b + b) % b;
+    d += (order - d) / b * b;
+    next_denominator_ = static_cast<T>(d);
+    next_numerator_ = static_cast<T>((1 + a * d) / b);
+}
+
+template <class T>
+typename FareySequence<T>::iterator FareySequence<T>::begin() const {
+    iterator it;
+    it.order_ = order_;
+    it.numerator_ = lower_numerator_;
+    it.denominator_ = lower_denominator_;
+    it.next_numerator_ = next_numerator_;
+    it.next_denominator_ = next_denominator_;
+    it.upper_numerator_ = upper_numerator_;
+    it.upper_denominator_ = upper_denominator_;
+    it.include_upper_ = include_upper_;
+    it.done_ = !include_upper_ && it.atUpper();
+    return it;
+}
+
+template <class T>
+typename FareySequence<T>::iterator FareySequence<T>::end() const {
+    iterator it = begin();
+    it.done_ = true;
+    return it;
+}
+
+/**
+ * INCREMENT - MOVES TO THE NEXT TERM
+ *
+ * Applies the next term recurrence and stops at upper.
+ */
+template <class T>
+typename FareySequence<T>::iterator &FareySequence<T>::iterator::operator++() {
+    if (atUpper()) {
+        done_ = true;
+        return *this;
+    }
+    T k = (order_ + denominator_) / next_denominator_;
+    T following_numerator = k * next_numerator_ - numerator_;
+    T following_denominator = k * next_denominator_ - denominator_;
+    numerator_ = next_numerator_;
+    denominator_ = next_denominator_;
+    next_numerator_ = following_numerator;
+    next_denominator_ = following_denominator;
+    if (!include_upper_ && atUpper())
+        done_ = true;
+    return *this;
+}
+
+template <class T>
+typename FareySequence<T>::iterator FareySequence<T>::iterator::operator++(int) {
+    iterator temp = *this;
+    ++(*this);
+    return temp;
+}
+
+template <class T>
+bool FareySequence<T>::iterator::operator==(const iterator &other) const {
+    if (done_ || other.done_)
+        return done_ == other.done_;
+    return numerator_ == other.numerator_ && denominator_ == other.denominator_;
+}
+
+/**
+ * PARTITION - SPLITS F_N FOR PARALLEL ENUMERATION
+ *
+ * Boundaries are floor(k * N / parts) / N, which always belong to F_N.
+ * Subranges are half open except the last one, which ends at 1/1 inclusive,
+ * so together they yield every term exactly once.
+ * Parts beyond N come out empty.
+ */
+template <class T>
+std::vector<FareySequence<T>> FareySequence<T>::partition(const T &order, std::size_t parts) {
+    if (parts == 0)
+        throw std::invalid_argument("Farey sequence must be split into at least one part.");
+    using W = detail::Wide<T>;
+    std::vector<FareySequence<T>> result;
+    result.reserve(parts);
+    Fraction<T> lower(0);
+    for (std::size_t part = 1; part <= parts; ++part) {
+        Fraction<T> upper(static_cast<T>(static_cast<W>(order) * static_cast<W>(part) / static_cast<W>(parts)), order);
+        result.emplace_back(order, lower, upper, part == parts);
+        lower = upper;
+    }
+    return result;
+}
+
+/**
+ * CALKIN WILF SEQUENCE CLASS
+ *
+ * Range over every positive rational, each exactly once and reduced, in breadth first order of the Calkin-Wilf tree:
+ *
+ * 1/1, 1/2, 2/1, 1/3, 3/2, 2/3, 3/1, ...
+ *
+ * Each row of the tree holds the same fractions as the matching row of the Stern-Brocot tree.
+ * Term at index i is reached from 1/1 by following the bits of i below the leading one,
+ * the term after x is 1 / (2 * floor(x) + 1 - x), so walking costs no gcd.
+ * Indices start at 1, any index range [first, last) can be walked on its own thread.
+ */
+template <class T>
+class CalkinWilfSequence {
+private:
+    // members
+    std::uint64_t first_index_;
+    std::uint64_t last_index_;
+
+    // methods
+    static T checkedAdd(const T &lhs, const T &rhs);  // adds and throws std::overflow_error on overflow
+
+public:
+    class iterator {
+    private:
+        std::uint64_t index_;
+        std::uint64_t last_index_;
+        T numerator_;
+        T denominator_;
+
+        friend class CalkinWilfSequence<T>;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Fraction<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Fraction<T>;
+
+        Fraction<T> operator*() const { return Fraction<T>(numerator_, denominator_, typename Fraction<T>::ReducedTag{}); }
+        iterator &operator++();
+        iterator operator++(int);
+        bool operator==(const iterator &other) const { return index_ == other.index_; }
+        bool operator!=(const iterator &other) const { return index_ != other.index_; }
+    };
+
+    // constructors
+    explicit CalkinWilfSequence(std::uint64_t count);                     // first count terms
+    CalkinWilfSequence(std::uint64_t first_index, std::uint64_t last_index);  // terms with index in [first_index, last_index)
+
+    // range
+    iterator begin() const;
+    iterator end() const;
+
+    static Fraction<T> term(std::uint64_t index);                                                     // returns term at index
+    static std::vector<CalkinWilfSequence<T>> partition(std::uint64_t count, std::size_t parts);  // splits first count terms into parts ranges
+};
+
+template <class T>
+T CalkinWilfSequence<T>::checkedAdd(const T &lhs, const T &rhs) {
+    T result;
+    if (__builtin_add_overflow(lhs, rhs, &result))
+        throw std::overflow_error("Calkin-Wilf term does not fit in the fraction type.");
+    return result;
+}
+
+template <class T>
+CalkinWilfSequence<T>::CalkinWilfSequence(std::uint64_t count) : CalkinWilfSequence(1, count + 1) {}
+
+template <class T>
+CalkinWilfSequence<T>::CalkinWilfSequence(std::uint64_t first_index, std::uint64_t last_index) : first_index_(first_index), last_index_(last_index) {
+    if (first_index == 0 || first_index > last_index)
+        throw std::invalid_argument("Calkin-Wilf range must satisfy 1 <= first_index <= last_index.");
+}
+
+/**
+ * TERM - RETURNS TERM AT INDEX
+ *
+ * Walks down from the root 1/1, bit 0 goes to the left child a / (a + b), bit 1 to the right child (a + b) / b.
+ */
+template <class T>
+Fraction<T> CalkinWilfSequence<T>::term(std::uint64_t index) {
+    if (index == 0)
+        throw std::invalid_argument("Calkin-Wilf indices start at 1.");
+    int bit = 63;
+    while (!(index >> bit & 1u))
+        --bit;
+    T numerator = 1;
+    T denominator = 1;
+    for (--bit; bit >= 0; --bit) {
+        if (index >> bit & 1u)
+            numerator = checkedAdd(numerator, denominator);
+        else
+            denominator = checkedAdd(numerator, denominator);
+    }
+    return Fraction<T>(numerator, denominator, typename Fraction<T>::ReducedTag{});
+}
+
+template <class T>
+typename CalkinWilfSequence<T>::iterator CalkinWilfSequence<T>::begin() const {
+    iterator it;
+    it.index_ = first_index_;
+    it.last_index_ = last_index_;
+    it.numerator_ = 1;
+    it.denominator_ = 1;
+    if (first_index_ != last_index_) {
+        Fraction<T> first = term(first_index_);
+        it.numerator_ = first.getNumerator();
+        it.denominator_ = first.getDenominator();
+    }
+    return it;
+}
+
+template <class T>
+typename CalkinWilfSequence<T>::iterator CalkinWilfSequence<T>::end() const {
+    iterator it;
+    it.index_ = last_index_;
+    it.last_index_ = last_index_;
+    it.numerator_ = 1;
+    it.denominator_ = 1;
+    return it;
+}
+
+/**
+ * INCREMENT - MOVES TO THE NEXT TERM
+ *
+ * For x = a/b with a = q * b + r the next term is b / ((q + 1) * b - r) = b / ((a - r) + (b - r)).
+ * Stepping onto the end of the range skips the computation, so a term past the range never overflows.
+ */
+template <class T>
+typename CalkinWilfSequence<T>::iterator &CalkinWilfSequence<T>::iterator::operator++() {
+    if (++index_ == last_index_)
+        return *this;
+    T remainder = numerator_ % denominator_;
+    T next_denominator = checkedAdd(numerator_ - remainder, denominator_ - remainder);
+    numerator_ = denominator_;
+    denominator_ = next_denominator;
+    return *this;
+}
+
+template <class T>
+typename CalkinWilfSequence<T>::iterator CalkinWilfSequence<T>::iterator::operator++(int) {
+    iterator temp = *this;
+    ++(*this);
+    return temp;
+}
+
+/**
+ * PARTITION - SPLITS THE FIRST COUNT TERMS FOR PARALLEL ENUMERATION
+ *
+ * Index ranges are as equal as possible and together cover indices 1 to count.
+ */
+template <class T>
+std::vector<CalkinWilfSequence<T>> CalkinWilfSequence<T>::partition(std::uint64_t count, std::size_t parts) {
+    if (parts == 0)
+        throw std::invalid_argument("Calkin-Wilf sequence must be split into at least one part.");
+    std::vector<CalkinWilfSequence<T>> result;
+    result.reserve(parts);
+    std::uint64_t first = 1;
+    for (std::size_t part = 1; part <= parts; ++part) {
+        std::uint64_t last = 1 + count / parts * part + std::min<std::uint64_t>(part, count % parts);
+        result.emplace_back(first, last);
+        first = last;
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <algorithm>    //for std::sort, std::min
+#include <atomic>       //for std::atomic
+#include <chrono>       //for std::chrono::steady_clock
+#include <cstddef>      //for std::size_t
+#include <cstdint>      //for std::uint8_t, std::uint64_t
+#include <fstream>      //for std::ofstream, std::ifstream
+#include <iterator>     //for std::istreambuf_iterator
+#include <mutex>        //for std::mutex, std::lock_guard
+#include <stdexcept>    //for std::runtime_error, std::invalid_argument
+#include <string>       //for std::string
+#include <thread>       //for std::this_thread::yield
+#include <type_traits>  //for std::make_unsigned<T>
+#include <vector>       //for std::vector
+
+#include "Fraction.hpp"
+
+namespace Fraction{
+/**
+ * TRACE FORMAT
+ *
+ * Header: the bytes "FRTR", format version and sizeof(T).
+ * Then one record per operation: operation byte followed by numerator and denominator of
+ * lhs, rhs and result, each zigzag encoded as a variable length integer (7 bits per byte, low bits first).
+ * Comparison results are stored as 1/1 for true and 0/1 for false.
+ * Only numbers are stored, nothing that identifies where they came from.
+ */
+constexpr char TRACE_MAGIC[4] = {'F', 'R', 'T', 'R'};
+constexpr std::uint8_t TRACE_VERSION = 1;
+
+template <class T>
+struct TraceRecord {
+    TraceOperation operation;
+    T lhs_numerator;
+    T lhs_denominator;
+    T rhs_numerator;
+    T rhs_denominator;
+    T result_numerator;
+    T result_denominator;
+};
+
+/**
+ * TRACE RECORDER CLASS
+ *
+ * Writes a trace of every Fraction<T> operation while it is active.
+ * Operators only report operations when the program is compiled with FRACTION_TRACE,
+ * at most one recorder per T is active at a time.
+ * Records are buffered and written under a mutex, so a traced program runs slower than an untraced one,
+ * the trace is meant to capture operands, not timings.
+ * stop() waits for operations that already picked up the recorder to finish recording,
+ * so the recorder may be stopped and destroyed while other threads keep running traced operations.
+ */
+template <class T>
+class TraceRecorder {
+private:
+    // members
+    std::ofstream file_;
+    std::vector<char> buffer_;
+    std::mutex mutex_;
+    static std::atomic<TraceRecorder<T> *> active_;
+    static std::atomic<std::size_t> in_flight_;  // operations between loading active_ and finishing record()
+
+    // methods
+    void writeVarint(T value);  // appends zigzag encoded value to buffer
+    void flushBuffer();         // writes buffer to file
+
+public:
+    // constructors
+    explicit TraceRecorder(const std::string &path);  // creates trace file and writes header
+    ~TraceRecorder();                                 // stops recording and flushes
+    TraceRecorder(const TraceRecorder &) = delete;
+    TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+    // recording
+    void start();  // makes this the recorder operators report to
+    void stop();   // stops operators from reporting to this recorder and waits for records in flight
+    void record(TraceOperation operation, const Fraction<T> &lhs, const Fraction<T> &rhs, const Fraction<T> &result);  // appends one record
+    void flush();  // writes buffered records to the file
+
+    static TraceRecorder<T> *active() { return active_.load(std::memory_order_acquire); }  // returns active recorder or nullptr
+    static void recordActive(TraceOperation operation, const Fraction<T> &lhs, const Fraction<T> &rhs, const Fraction<T> &result);  // records to active recorder if any
+};
+
+template <class T>
+std::atomic<TraceRecorder<T> *> TraceRecorder<T>::active_{nullptr};
+
+template <class T>
+std::atomic<std::size_t> TraceRecorder<T>::in_flight_{0};
+
+template <class T>
+TraceRecorder<T>::TraceRecorder(const std::string &path) : file_(path, std::ios::binary | std::ios::trunc) {
+    if (!file_)
+        throw std::runtime_error("Cannot create trace file " + path + ".");
+    buffer_.reserve(1 << 16);
+    buffer_.insert(buffer_.end(), TRACE_MAGIC, TRACE_MAGIC + 4);
+    buffer_.push_back(static_cast<char>(TRACE_VERSION));
+    buffer_.push_back(static_cast<char>(sizeof(T)));
+}
+
+template <class T>
+TraceRecorder<T>::~TraceRecorder() {
+    stop();
+    flush();
+}
+
+template <class T>
+void TraceRecorder<T>::start() {
+    active_.store(this, std::memory_order_release);
+}
+
+/**
+ * STOP
+ *
+ * recordActive() counts itself in before it loads active_, and stop() clears active_ before it reads the count,
+ * both sequentially consistent, so an operation either sees no recorder or is waited for here.
+ * Waits even if another recorder took over, an operation may still hold this one.
+ */
+template <class T>
+void TraceRecorder<T>::stop() {
+    TraceRecorder<T> *expected = this;
+    active_.compare_exchange_strong(expected, nullptr);
+    while (in_flight_.load() != 0)
+        std::this_thread::yield();
+}
+
+template <class T>
+void TraceRecorder<T>::recordActive(TraceOperation operation, const Fraction<T> &lhs, const Fraction<T> &rhs, const Fraction<T> &result) {
+    in_flight_.fetch_add(1);
+    if (TraceRecorder<T> *recorder = active_.load()) {
+        try {
+            recorder->record(operation, lhs, rhs, result);
+        } catch (...) {
+            in_flight_.fetch_sub(1);
+            throw;
+        }
+    }
+    in_flight_.fetch_sub(1);
+}
+
+template <class T>
+void TraceRecorder<T>::writeVarint(T value) {
+    using Unsigned = typename std::make_unsigned<T>::type;
+    // non negative v becomes 2v, negative v becomes 2(~v) + 1, so small magnitudes take few bytes
+    Unsigned bits = static_cast<Unsigned>(value);
+    std::uint64_t zigzag = value < 0 ? (static_cast<std::uint64_t>(static_cast<Unsigned>(~bits)) << 1) | 1u : static_cast<std::uint64_t>(bits) << 1;
+    while (zigzag >= 0x80) {
+        buffer_.push_back(static_cast<char>(zigzag | 0x80));
+        zigzag >>= 7;
+    }
+    buffer_.push_back(static_cast<char>(zigzag));
+}
+
+template <class T>
+void TraceRecorder<T>::record(TraceOperation operation, const Fraction<T> &lhs, const Fraction<T> &rhs, const Fraction<T> &result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer_.push_back(static_cast<char>(operation));
+    writeVarint(lhs.getNumerator());
+    writeVarint(lhs.getDenominator());
+    writeVarint(rhs.getNumerator());
+    writeVarint(rhs.getDenominator());
+    writeVarint(result.getNumerator());
+    writeVarint(result.getDenominator());
+    if (buffer_.size() >= (1 << 16))
+        flushBuffer();
+}
+
+template <class T>
+void TraceRecorder<T>::flushBuffer() {
+    file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    file_.flush();
+    buffer_.clear();
+}
+
+template <class T>
+void TraceRecorder<T>::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flushBuffer();
+}
+
+/**
+ * TRACE RECORD HOOKS
+ *
+ * Called by the operators when compiled with FRACTION_TRACE, forward to the active recorder if there is one.
+ */
+template <class T>
+void traceRecord(TraceOperation operation, const Fraction<T> &lhs, const Fraction<T> &rhs, const Fraction<T> &result) {
+    TraceRecorder<T>::recordActive(operation, lhs, rhs, result);
+}
+
+template <class T>
+void traceRecord(TraceOperation operation, const Fraction<T> &lhs, const Fraction<T> &rhs, bool result) {
+    TraceRecorder<T>::recordActive(operation, lhs, rhs, Fraction<T>(result ? 1 : 0));
+}
+
+/**
+ * READ TRACE
+ *
+ * Returns sizeof(T) the trace at path was recorded with, or reads all its records.
+ * Throws runtime_error if the file is missing, not a trace, truncated, or recorded with a different T.
+ */
+inline std::size_t traceWidth(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    char header[6];
+    if (!file.read(header, sizeof(header)) || !std::equal(TRACE_MAGIC, TRACE_MAGIC + 4, header) ||
+        static_cast<std::uint8_t>(header[4]) != TRACE_VERSION)
+        throw std::runtime_error("File " + path + " is not a fraction trace.");
+    return static_cast<std::uint8_t>(header[5]);
+}
+
+template <class T>
+std::vector<TraceRecord<T>> readTrace(const std::string &path) {
+    if (traceWidth(path) != sizeof(T))
+        throw std::runtime_error("Trace " + path + " was recorded with a different fraction type.");
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::size_t position = 6;
+
+    using Unsigned = typename std::make_unsigned<T>::type;
+    auto readVarint = [&data, &position, &path]() {
+        std::uint64_t zigzag = 0;
+        for (int shift = 0;; shift += 7) {
+            if (position == data.size() || shift >= 64)
+                throw std::runtime_error("Trace " + path + " is truncated or corrupt.");
+            std::uint8_t byte = static_cast<std::uint8_t>(data[position++]);
+            zigzag |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                break;
+        }
+        Unsigned magnitude = static_cast<Unsigned>(zigzag >> 1);
+        return static_cast<T>(zigzag & 1 ? static_cast<Unsigned>(~magnitude) : magnitude);
+    };
+
+    std::vector<TraceRecord<T>> records;
+    while (position != data.size()) {
+        std::uint8_t operation = static_cast<std::uint8_t>(data[position++]);
+        if (operation > static_cast<std::uint8_t>(TraceOperation::Less))
+            throw std::runtime_error("Trace " + path + " is truncated or corrupt.");
+        TraceRecord<T> record;
+        record.operation = static_cast<TraceOperation>(operation);
+        record.lhs_numerator = readVarint();
+        record.lhs_denominator = readVarint();
+        record.rhs_numerator = readVarint();
+        record.rhs_denominator = readVarint();
+        record.result_numerator = readVarint();
+        record.result_denominator = readVarint();
+        records.push_back(record);
+    }
+    return records;
+}
+
+/**
+ * REPLAY TRACE - RUNS RECORDED OPERATIONS AGAINST THE CURRENT BUILD
+ *
+ * Operands are constructed before timing starts.
+ * Throughput comes from one untimed pass over all records, latency percentiles from a second pass
+ * that times every operation, so they include the clock overhead of a few tens of nanoseconds.
+ * A result that differs from the recorded one, or an operation that now throws, is a mismatch.
+ */
+struct TraceReplayReport {
+    std::size_t operations = 0;
+    std::size_t mismatches = 0;
+    std::vector<std::size_t> first_mismatches;  // indices of up to 16 mismatching records
+    double operations_per_second = 0;
+    double latency_p50_ns = 0;
+    double latency_p90_ns = 0;
+    double latency_p99_ns = 0;
+    double latency_max_ns = 0;
+};
+
+namespace detail{
+template <class T>
+Fraction<T> replayOperation(TraceOperation operation, const Fraction<T> &lhs, const Fraction<T> &rhs) {
+    switch (operation) {
+        case TraceOperation::Add:
+            return lhs + rhs;
+        case TraceOperation::Subtract:
+            return lhs - rhs;
+        case TraceOperation::Multiply:
+            return lhs * rhs;
+        case TraceOperation::Divide:
+            return lhs / rhs;
+        case TraceOperation::Equal:
+            return Fraction<T>(lhs == rhs ? 1 : 0);
+        case TraceOperation::Greater:
+            return Fraction<T>(lhs > rhs ? 1 : 0);
+        case TraceOperation::Less:
+            return Fraction<T>(lhs < rhs ? 1 : 0);
+    }
+    throw std::invalid_argument("Unknown trace operation.");
+}
+}  // namespace detail
+
+template <class T>
+TraceReplayReport replayTrace(const std::vector<TraceRecord<T>> &records) {
+    using Clock = std::chrono::steady_clock;
+    TraceReplayReport report;
+    report.operations = records.size();
+    if (records.empty())
+        return report;
+
+    std::vector<Fraction<T>> operands;
+    operands.reserve(2 * records.size());
+    for (const TraceRecord<T> &record : records) {
+        operands.emplace_back(record.lhs_numerator, record.lhs_denominator);
+        operands.emplace_back(record.rhs_numerator, record.rhs_denominator);
+    }
+
+    std::vector<Fraction<T>> results(records.size());
+    std::vector<bool> failed(records.size(), false);
+    Clock::time_point start = Clock::now();
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        try {
+            results[i] = detail::replayOperation(records[i].operation, operands[2 * i], operands[2 * i + 1]);
+        } catch (const std::exception &) {
+            failed[i] = true;
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    report.operations_per_second = seconds > 0 ? records.size() / seconds : 0;
+
+    std::vector<double> latencies(records.size());
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        Clock::time_point operation_start = Clock::now();
+        try {
+            Fraction<T> result = detail::replayOperation(records[i].operation, operands[2 * i], operands[2 * i + 1]);
+            (void)result;
+        } catch (const std::exception &) {
+        }
+        latencies[i] = std::chrono::duration<double, std::nano>(Clock::now() - operation_start).count();
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double fraction) { return latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(fraction * latencies.size()))]; };
+    report.latency_p50_ns = percentile(0.50);
+    report.latency_p90_ns = percentile(0.90);
+    report.latency_p99_ns = percentile(0.99);
+    report.latency_max_ns = latencies.back();
+
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        if (failed[i] || results[i].getNumerator() != records[i].result_numerator || results[i].getDenominator() != records[i].result_denominator) {
+            ++report.mismatches;
+            if (report.first_mismatches.size() < 16)
+                report.first_mismatches.push_back(i);
+        }
+    }
+    return report;
+}
+
+}
@@ -1,6 +1,17 @@
+#include <algorithm>
 #include <array>
+#include <cstdio>
+#include <fstream>
 #include <limits>
-
+#include <thread>
+#include <vector>
+
+#include <backend/cpp/AtomicFraction.hpp>
+#include <backend/cpp/FractionCompare.hpp>
+#include <backend/cpp/FractionExpression.hpp>
+#include <backend/cpp/FractionReader.hpp>
+#include <backend/cpp/FractionSequence.hpp>
+#include <backend/cpp/FractionTrace.hpp>
 #include <backend/cpp/Fractions.hpp>
 #include <gtest/gtest.h>
 
@@ -403,4 +414,411 @@ TEST(FractionTest, FractionAndInts) {
     EXPECT_EQ(f2 > -5, true);
 }
 
+TEST(FractionTest, Pow) {
+    Fraction<long int> f1(-2, 3);
+    Fraction<long int> result = pow(f1, 3);
+    EXPECT_EQ(result.getNumerator(), -8);
+    EXPECT_EQ(result.getDenominator(), 27);
+    result = pow(f1, 0);
+    EXPECT_EQ(result.getNumerator(), 1);
+    EXPECT_EQ(result.getDenominator(), 1);
+    result = pow(f1, -2);
+    EXPECT_EQ(result.getNumerator(), 9);
+    EXPECT_EQ(result.getDenominator(), 4);
+    result = pow(f1, -3);
+    EXPECT_EQ(result.getNumerator(), -27);
+    EXPECT_EQ(result.getDenominator(), 8);
+
+    Fraction<long int> f2(0, 5);
+    EXPECT_EQ(pow(f2, 4) == 0, true);
+    EXPECT_THROW(pow(f2, -1), std::invalid_argument);
+
+    Fraction<int> f3(1, 2);
+    EXPECT_EQ(pow(f3, 30).getDenominator(), 1 << 30);
+    EXPECT_THROW(pow(f3, 31), std::overflow_error);
+    EXPECT_THROW(pow(Fraction<int>(3, 1), std::numeric_limits<int>::min()), std::overflow_error);
+    EXPECT_EQ(pow(Fraction<int>(-2, 1), 31).getNumerator(), std::numeric_limits<int>::min());
+    EXPECT_THROW(pow(Fraction<int>(2, 1), 31), std::overflow_error);
+    EXPECT_THROW(pow(Fraction<int>(-2, 1), 32), std::overflow_error);
+    EXPECT_EQ(pow(Fraction<signed char>(-3, 1), 3).getNumerator(), -27);
+    EXPECT_THROW(pow(Fraction<signed char>(-3, 1), 5), std::overflow_error);
+}
+TEST(FractionTest, Powers) {
+    Fraction<long int> f1(3, -2);
+    std::vector<Fraction<long int>> result = powers(f1, 4);
+    ASSERT_EQ(result.size(), 5u);
+    for (int i = 0; i <= 4; ++i) {
+        EXPECT_EQ(result[i] == pow(f1, i), true);
+    }
+    EXPECT_EQ(result[3].getNumerator(), -27);
+    EXPECT_EQ(result[3].getDenominator(), 8);
+    EXPECT_EQ(powers(f1, 0).size(), 1u);
+    EXPECT_THROW(powers(f1, -1), std::invalid_argument);
+    EXPECT_THROW(powers(Fraction<signed char>(1, 3), 5), std::overflow_error);
+}
+
+TEST(FractionTest, AtomicLoadStore) {
+    AtomicFraction<long int> f1(Fraction<long int>(-3, 4));
+    EXPECT_EQ(f1.load() == Fraction<long int>(-3, 4), true);
+    // full width numerator and denominator, min itself would hit std::gcd(min, ...) in the constructor
+    constexpr long int max_long = std::numeric_limits<long int>::max();
+    f1.store(Fraction<long int>(-max_long, max_long - 1));
+    EXPECT_EQ(f1.load().getNumerator(), -max_long);
+    EXPECT_EQ(f1.load().getDenominator(), max_long - 1);
+
+    AtomicFraction<short> f2(Fraction<short>(-5, 7));
+    EXPECT_EQ(f2.load().getNumerator(), -5);
+    EXPECT_EQ(f2.load().getDenominator(), 7);
+}
+TEST(FractionTest, AtomicCompareExchange) {
+    AtomicFraction<long int> f1(Fraction<long int>(1, 2));
+    Fraction<long int> expected(1, 3);
+    EXPECT_EQ(f1.compare_exchange(expected, Fraction<long int>(5, 6)), false);
+    EXPECT_EQ(expected == Fraction<long int>(1, 2), true);
+    EXPECT_EQ(f1.compare_exchange(expected, Fraction<long int>(5, 6)), true);
+    EXPECT_EQ(f1.load() == Fraction<long int>(5, 6), true);
+}
+TEST(FractionTest, AtomicFetchOperations) {
+    AtomicFraction<int> f1(Fraction<int>(1, 2));
+    EXPECT_EQ(f1.fetch_add(Fraction<int>(1, 3)) == Fraction<int>(1, 2), true);
+    EXPECT_EQ(f1.load() == Fraction<int>(5, 6), true);
+    EXPECT_EQ(f1.fetch_mul(Fraction<int>(-3, 5)) == Fraction<int>(5, 6), true);
+    EXPECT_EQ(f1.load() == Fraction<int>(-1, 2), true);
+}
+TEST(FractionTest, AtomicConcurrentAdd) {
+    AtomicFraction<long int> atomic_sum;
+    ShardedFraction<long int, 4> sharded_sum;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&atomic_sum, &sharded_sum] {
+            for (int i = 0; i < 1000; ++i) {
+                atomic_sum.fetch_add(Fraction<long int>(1, 4));
+                sharded_sum.add(Fraction<long int>(1, 6));
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(atomic_sum.load() == 1000, true);
+    EXPECT_EQ(sharded_sum.load() == Fraction<long int>(2000, 3), true);
+    sharded_sum.reset();
+    EXPECT_EQ(sharded_sum.load() == 0, true);
+}
+
+TEST(FractionTest, ExpressionEvaluation) {
+    Fraction<long int> f1(1, 2);
+    Fraction<long int> f2(1, 3);
+    Fraction<long int> f3(2, -3);
+    Fraction<long int> f4(5, 6);
+    Fraction<long int> result = lazy(f1) + f2 * lazy(f3) - f4;
+    EXPECT_EQ(result == f1 + f2 * f3 - f4, true);
+    EXPECT_EQ(result.getNumerator(), -5);
+    EXPECT_EQ(result.getDenominator(), 9);
+
+    result = (lazy(f1) - 2) / f3 + 1;
+    EXPECT_EQ(result.getNumerator(), 13);
+    EXPECT_EQ(result.getDenominator(), 4);
+
+    result = 3 * lazy(f2) / (lazy(f1) * 4);
+    EXPECT_EQ(result.getNumerator(), 1);
+    EXPECT_EQ(result.getDenominator(), 2);
+
+    auto expression = lazy(f4) * f4;
+    f4 = Fraction<long int>(0);
+    EXPECT_EQ(expression.evaluate() == Fraction<long int>(25, 36), true);
+    EXPECT_THROW(Fraction<long int>(lazy(f1) / f4), std::invalid_argument);
+}
+TEST(FractionTest, ExpressionWideIntermediates) {
+    constexpr long int max_long = std::numeric_limits<long int>::max();
+    Fraction<long int> f1(max_long, 3);
+    Fraction<long int> f2(3, max_long);
+    Fraction<long int> result = lazy(f1) * f1 * f2 * f2;
+    EXPECT_EQ(result == 1, true);
+    EXPECT_THROW(Fraction<long int>(lazy(f1) * f1), std::overflow_error);
+
+    Fraction<int> f3(std::numeric_limits<int>::max(), 2);
+    Fraction<int> f4 = lazy(f3) + f3 - f3;
+    EXPECT_EQ(f4.getNumerator(), std::numeric_limits<int>::max());
+    EXPECT_EQ(f4.getDenominator(), 2);
+}
+
+TEST(FractionTest, FareySequence) {
+    std::vector<Fraction<long int>> terms;
+    for (const Fraction<long int> &term : FareySequence<long int>(5)) {
+        terms.push_back(term);
+    }
+    std::vector<Fraction<long int>> expected = {{0, 1}, {1, 5}, {1, 4}, {1, 3}, {2, 5}, {1, 2}, {3, 5}, {2, 3}, {3, 4}, {4, 5}, {1, 1}};
+    ASSERT_EQ(terms.size(), expected.size());
+    for (std::size_t i = 0; i < terms.size(); ++i) {
+        EXPECT_EQ(terms[i].getNumerator(), expected[i].getNumerator());
+        EXPECT_EQ(terms[i].getDenominator(), expected[i].getDenominator());
+    }
+
+    terms.clear();
+    for (const Fraction<long int> &term : FareySequence<long int>(5, Fraction<long int>(1, 3), Fraction<long int>(3, 5))) {
+        terms.push_back(term);
+    }
+    ASSERT_EQ(terms.size(), 3u);
+    EXPECT_EQ(terms[0] == Fraction<long int>(1, 3), true);
+    EXPECT_EQ(terms[2] == Fraction<long int>(1, 2), true);
+
+    EXPECT_THROW(FareySequence<long int>(5, Fraction<long int>(1, 6), Fraction<long int>(1, 2)), std::invalid_argument);
+    EXPECT_THROW(FareySequence<long int>(0), std::invalid_argument);
+}
+TEST(FractionTest, FareyPartition) {
+    std::size_t count = 0;
+    Fraction<int> previous(-1);
+    for (const FareySequence<int> &part : FareySequence<int>::partition(60, 7)) {
+        for (const Fraction<int> &term : part) {
+            EXPECT_EQ(previous < term, true);
+            previous = term;
+            ++count;
+        }
+    }
+    std::size_t expected = 1;
+    for (int d = 1; d <= 60; ++d) {
+        for (int n = 1; n <= d; ++n) {
+            expected += std::gcd(n, d) == 1;
+        }
+    }
+    EXPECT_EQ(count, expected);
+    EXPECT_EQ(previous == 1, true);
+
+    // orders past sqrt of the int maximum, bounds products no longer fit in int
+    for (int order : {100000, 100000000}) {
+        std::vector<FareySequence<int>> parts = FareySequence<int>::partition(order, 7);
+        ASSERT_EQ(parts.size(), 7u);
+        for (std::size_t part = 0; part < parts.size(); ++part) {
+            Fraction<int> lower(static_cast<int>(static_cast<long long>(order) * static_cast<long long>(part) / 7), order);
+            FareySequence<int>::iterator it = parts[part].begin();
+            EXPECT_EQ((*it).getNumerator(), lower.getNumerator());
+            EXPECT_EQ((*it).getDenominator(), lower.getDenominator());
+            // neighbours a/b < c/d in F_N satisfy b * c - a * d = 1
+            for (int i = 0; i < 1000 && it != parts[part].end(); ++i) {
+                Fraction<int> term = *it;
+                if (++it == parts[part].end())
+                    break;
+                Fraction<int> next = *it;
+                EXPECT_EQ(static_cast<long long>(term.getDenominator()) * next.getNumerator() -
+                              static_cast<long long>(term.getNumerator()) * next.getDenominator(),
+                          1);
+                EXPECT_EQ(next.getDenominator() <= order, true);
+            }
+        }
+    }
+    EXPECT_THROW(FareySequence<int>(100000, Fraction<int>(99999, 100000), Fraction<int>(99998, 99999)), std::invalid_argument);
+}
+TEST(FractionTest, CalkinWilfSequence) {
+    std::vector<Fraction<long int>> terms;
+    for (const Fraction<long int> &term : CalkinWilfSequence<long int>(7)) {
+        terms.push_back(term);
+    }
+    std::vector<Fraction<long int>> expected = {{1, 1}, {1, 2}, {2, 1}, {1, 3}, {3, 2}, {2, 3}, {3, 1}};
+    ASSERT_EQ(terms.size(), expected.size());
+    for (std::size_t i = 0; i < terms.size(); ++i) {
+        EXPECT_EQ(terms[i].getNumerator(), expected[i].getNumerator());
+        EXPECT_EQ(terms[i].getDenominator(), expected[i].getDenominator());
+    }
+
+    std::uint64_t index = 1;
+    for (const CalkinWilfSequence<long int> &part : CalkinWilfSequence<long int>::partition(1000, 3)) {
+        for (const Fraction<long int> &term : part) {
+            EXPECT_EQ(term == CalkinWilfSequence<long int>::term(index), true);
+            ++index;
+        }
+    }
+    EXPECT_EQ(index, 1001u);
+    EXPECT_THROW(CalkinWilfSequence<long int>::term(0), std::invalid_argument);
+}
+
+TEST(FractionTest, ParseFraction) {
+    Fraction<long int> result = parseFraction<long int>("12.375");
+    EXPECT_EQ(result.getNumerator(), 99);
+    EXPECT_EQ(result.getDenominator(), 8);
+    result = parseFraction<long int>(" 1.2e-3 ");
+    EXPECT_EQ(result.getNumerator(), 3);
+    EXPECT_EQ(result.getDenominator(), 2500);
+    result = parseFraction<long int>("-.50000000000000000000000000");
+    EXPECT_EQ(result.getNumerator(), -1);
+    EXPECT_EQ(result.getDenominator(), 2);
+    result = parseFraction<long int>("5E+2");
+    EXPECT_EQ(result == 500, true);
+    result = parseFraction<long int>("6/-4");
+    EXPECT_EQ(result.getNumerator(), -3);
+    EXPECT_EQ(result.getDenominator(), 2);
+    result = parseFraction<long int>("-9223372036854775808");
+    EXPECT_EQ(result.getNumerator(), std::numeric_limits<long int>::min());
+    EXPECT_EQ(result.getDenominator(), 1);
+    result = parseFraction<long int>("-92233720368547758.08e2");
+    EXPECT_EQ(result.getNumerator(), std::numeric_limits<long int>::min());
+    EXPECT_EQ(result.getDenominator(), 1);
+
+    EXPECT_THROW(parseFraction<long int>("1.2.3"), std::invalid_argument);
+    EXPECT_THROW(parseFraction<long int>("e5"), std::invalid_argument);
+    EXPECT_THROW(parseFraction<long int>("1/0"), std::invalid_argument);
+    EXPECT_THROW(parseFraction<int>("1e10"), std::overflow_error);
+    EXPECT_THROW(parseFraction<int>("1.0000000001"), std::overflow_error);
+
+    // values that fit although 10^k or the digits themselves do not
+    Fraction<int> small = parseFraction<int>("5e-10");
+    EXPECT_EQ(small.getNumerator(), 1);
+    EXPECT_EQ(small.getDenominator(), 2000000000);
+    small = parseFraction<int>("0.0000000005");
+    EXPECT_EQ(small.getNumerator(), 1);
+    EXPECT_EQ(small.getDenominator(), 2000000000);
+    small = parseFraction<int>("10000000000e-5");
+    EXPECT_EQ(small.getNumerator(), 100000);
+    EXPECT_EQ(small.getDenominator(), 1);
+    small = parseFraction<int>("-1200000000000.0e-9");
+    EXPECT_EQ(small.getNumerator(), -1200);
+    EXPECT_EQ(small.getDenominator(), 1);
+    result = parseFraction<long int>("5e-19");
+    EXPECT_EQ(result.getNumerator(), 1);
+    EXPECT_EQ(result.getDenominator(), 2000000000000000000);
+    result = parseFraction<long int>("0e99999999999999999999");
+    EXPECT_EQ(result.getNumerator(), 0);
+    EXPECT_EQ(result.getDenominator(), 1);
+    result = parseFraction<long int>("-0.000e-99999999999999999999");
+    EXPECT_EQ(result.getNumerator(), 0);
+    EXPECT_THROW(parseFraction<int>("5e-11"), std::overflow_error);
+    EXPECT_THROW(parseFraction<int>("3e-10"), std::overflow_error);
+    EXPECT_THROW(parseFraction<long int>("0e"), std::invalid_argument);
+    EXPECT_THROW(parseFraction<long int>("1e99999999999999999999"), std::overflow_error);
+}
+TEST(FractionTest, ReadCsv) {
+    std::string path = ::testing::TempDir() + "fraction_read_csv_test.csv";
+    {
+        std::ofstream file(path);
+        file << "price, rate\r\n";
+        for (int i = 0; i < 1000; ++i) {
+            file << i << ".25," << i << "/7\r\n";
+        }
+        file << "\n";
+    }
+    CsvOptions options;
+    options.header = true;
+    options.threads = 4;
+    options.chunk_bytes = 1000;
+    FractionColumns<long int> table = readCsv<long int>(path, options);
+    ASSERT_EQ(table.columnCount(), 2u);
+    ASSERT_EQ(table.rowCount(), 1000u);
+    EXPECT_EQ(table.names()[1], "rate");
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(table.column(0)[i] == Fraction<long int>(4 * i + 1, 4), true);
+        EXPECT_EQ(table.column(1)[i] == Fraction<long int>(i, 7), true);
+    }
+
+    // fields and lines longer than one 16 byte block, delimiters on the last and first byte of a block
+    {
+        std::ofstream file(path);
+        file << "12345678901.2345,1234567/7654321,   -0.125   \n";
+        file << "1/2,99999999999999999/100000000000000000,3\n";
+    }
+    FractionColumns<long int> wide = readCsv<long int>(path);
+    ASSERT_EQ(wide.columnCount(), 3u);
+    ASSERT_EQ(wide.rowCount(), 2u);
+    const long int expected[2][3][2] = {{{24691357802469, 2000}, {1234567, 7654321}, {-1, 8}},
+                                        {{1, 2}, {99999999999999999, 100000000000000000}, {3, 1}}};
+    for (std::size_t row = 0; row < 2; ++row) {
+        for (std::size_t column = 0; column < 3; ++column) {
+            EXPECT_EQ(wide.column(column)[row].getNumerator(), expected[row][column][0]);
+            EXPECT_EQ(wide.column(column)[row].getDenominator(), expected[row][column][1]);
+        }
+    }
+
+    {
+        std::ofstream file(path);
+        file << "1,2\n3\n";
+    }
+    EXPECT_THROW(readCsv<long int>(path), std::invalid_argument);
+    {
+        std::ofstream file(path);
+        file << "1,2\n3,99999999999999999999\n";
+    }
+    try {
+        readCsv<long int>(path);
+        ADD_FAILURE() << "expected overflow_error";
+    } catch (const std::overflow_error &error) {
+        EXPECT_NE(std::string(error.what()).find("byte 6"), std::string::npos);
+    }
+    EXPECT_THROW(readCsv<long int>(path + ".missing"), std::system_error);
+    std::remove(path.c_str());
+}
+
+TEST(FractionTest, FilteredComparison) {
+    constexpr long int max_long = std::numeric_limits<long int>::max();
+    Fraction<long int> f1(-3, 4);
+    Fraction<long int> f2(1, 4);
+    EXPECT_EQ(compare(f1, f2), -1);
+    EXPECT_EQ(compare(f2, f1), 1);
+    EXPECT_EQ(compare(f1, f1), 0);
+    EXPECT_EQ(compare<ExactComparison>(f1, f2), -1);
+
+    // neighbours in a Farey sequence of huge order round to the same double
+    Fraction<long int> f3(max_long - 2, max_long - 1);
+    Fraction<long int> f4(max_long - 1, max_long);
+    EXPECT_EQ(f3.toDouble() == f4.toDouble(), true);
+    EXPECT_EQ(compare(f3, f4), -1);
+    EXPECT_EQ(compare<FilteredComparison>(f3, f4), -1);
+    EXPECT_EQ(compare<FilteredComparison>(f4, f3), 1);
+    EXPECT_EQ(compare<FilteredComparison>(f4, f4), 0);
+    EXPECT_EQ(compare<FilteredComparison>(f1, f2), -1);
+    EXPECT_EQ(FilteredComparison::compare(f4, f4.toDouble(), f3, f3.toDouble()), 1);
+
+    std::vector<Fraction<long int>> values = {f4, f1, f3, f2, Fraction<long int>(0)};
+    std::sort(values.begin(), values.end(), Less<FilteredComparison>());
+    EXPECT_EQ(std::is_sorted(values.begin(), values.end(), Less<>()), true);
+    EXPECT_EQ(values.front() == f1, true);
+    EXPECT_EQ(values.back().getNumerator(), f4.getNumerator());
+    EXPECT_EQ(values.back().getDenominator(), f4.getDenominator());
+    EXPECT_EQ(GreaterEqual<>()(f4, f4), true);
+    EXPECT_EQ(Greater<>()(f3, f4), false);
+    EXPECT_EQ(LessEqual<>()(f3, f4), true);
+}
+
+TEST(FractionTest, TraceRecordAndReplay) {
+    std::string path = ::testing::TempDir() + "fraction_trace_test.frtr";
+    constexpr long int max_long = std::numeric_limits<long int>::max();
+    Fraction<long int> f1(-3, 4);
+    Fraction<long int> f2(1, 4);
+    Fraction<long int> f3(max_long, 1);
+    Fraction<long int> f4(-max_long, 1);
+    Fraction<long int> zero(0);
+    Fraction<long int> sum = f1 + f1;
+    {
+        TraceRecorder<long int> recorder(path);
+        recorder.start();
+        EXPECT_EQ(TraceRecorder<long int>::active(), &recorder);
+        recorder.record(TraceOperation::Add, f1, f1, sum);
+        recorder.record(TraceOperation::Multiply, f1, f2, Fraction<long int>(1, 2));  // wrong, replay gives -3/16
+        recorder.record(TraceOperation::Less, f1, f2, Fraction<long int>(1));
+        recorder.record(TraceOperation::Add, f3, zero, f3);
+        recorder.record(TraceOperation::Subtract, f4, zero, f4);
+    }
+    EXPECT_EQ(TraceRecorder<long int>::active(), nullptr);
+    EXPECT_EQ(traceWidth(path), sizeof(long int));
+
+    std::vector<TraceRecord<long int>> records = readTrace<long int>(path);
+    ASSERT_EQ(records.size(), 5u);
+    EXPECT_EQ(records[1].operation, TraceOperation::Multiply);
+    EXPECT_EQ(records[1].result_numerator, 1);
+    EXPECT_EQ(records[1].result_denominator, 2);
+    EXPECT_EQ(records[3].lhs_numerator, max_long);
+    EXPECT_EQ(records[4].operation, TraceOperation::Subtract);
+    EXPECT_EQ(records[4].result_numerator, -max_long);
+    EXPECT_EQ(records[0].result_numerator, -3);
+    EXPECT_EQ(records[0].result_denominator, 2);
+
+    TraceReplayReport report = replayTrace(records);
+    EXPECT_EQ(report.operations, 5u);
+    EXPECT_EQ(report.mismatches, 1u);
+    ASSERT_EQ(report.first_mismatches.size(), 1u);
+    EXPECT_EQ(report.first_mismatches[0], 1u);
+    EXPECT_EQ(report.latency_p50_ns <= report.latency_max_ns, true);
+
+    EXPECT_THROW(readTrace<int>(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
 }
@@ -0,0 +1,92 @@
+// Built as its own test binary together with FractionC.cpp, the other tests stay header only.
+#include <cstdint>
+#include <limits>
+
+#include <backend/cpp/FractionC.h>
+#include <gtest/gtest.h>
+
+TEST(FractionCTest, Arithmetic) {
+    int64_t a_numerators[3] = {1, 3, -4};
+    int64_t a_denominators[3] = {2, -4, 6};
+    int64_t b_numerators[3] = {1, 1, 2};
+    int64_t b_denominators[3] = {3, 4, -3};
+    int64_t out_numerators[3];
+    int64_t out_denominators[3];
+    EXPECT_EQ(fraction_i64_add(a_numerators, a_denominators, b_numerators, b_denominators, out_numerators, out_denominators, 3), FRACTION_OK);
+    EXPECT_EQ(out_numerators[0], 5);
+    EXPECT_EQ(out_denominators[0], 6);
+    EXPECT_EQ(out_numerators[1], -1);
+    EXPECT_EQ(out_denominators[1], 2);
+    EXPECT_EQ(out_numerators[2], -4);
+    EXPECT_EQ(out_denominators[2], 3);
+
+    EXPECT_EQ(fraction_i64_mul(a_numerators, a_denominators, b_numerators, b_denominators, out_numerators, out_denominators, 3), FRACTION_OK);
+    EXPECT_EQ(out_numerators[1], -3);
+    EXPECT_EQ(out_denominators[1], 16);
+    EXPECT_EQ(out_numerators[2], 4);
+    EXPECT_EQ(out_denominators[2], 9);
+
+    // output aliasing the first operand
+    EXPECT_EQ(fraction_i64_add(a_numerators, a_denominators, b_numerators, b_denominators, a_numerators, a_denominators, 3), FRACTION_OK);
+    EXPECT_EQ(a_numerators[0], 5);
+    EXPECT_EQ(a_denominators[0], 6);
+    EXPECT_EQ(a_numerators[2], -4);
+    EXPECT_EQ(a_denominators[2], 3);
+
+    int32_t small_numerators[2] = {std::numeric_limits<int32_t>::max(), 1};
+    int32_t small_denominators[2] = {1, 2};
+    int32_t small_out_numerators[2];
+    int32_t small_out_denominators[2];
+    EXPECT_EQ(fraction_i32_mul(small_numerators, small_denominators, small_numerators, small_denominators, small_out_numerators, small_out_denominators, 2),
+              FRACTION_OVERFLOW);
+    EXPECT_EQ(fraction_i32_add(small_numerators + 1, small_denominators + 1, small_numerators + 1, small_denominators + 1, small_out_numerators,
+                               small_out_denominators, 1),
+              FRACTION_OK);
+    EXPECT_EQ(small_out_numerators[0], 1);
+    EXPECT_EQ(small_out_denominators[0], 1);
+
+    int64_t zero[1] = {0};
+    EXPECT_EQ(fraction_i64_add(b_numerators, zero, b_numerators, b_denominators, out_numerators, out_denominators, 1), FRACTION_ZERO_DENOMINATOR);
+}
+
+TEST(FractionCTest, CompareReduceToDouble) {
+    int64_t a_numerators[4] = {1, -3, 2, 5};
+    int64_t a_denominators[4] = {2, 4, -3, -7};
+    int64_t b_numerators[4] = {1, 1, -2, 5};
+    int64_t b_denominators[4] = {3, -4, 3, 7};
+    int32_t order[4];
+    EXPECT_EQ(fraction_i64_compare(a_numerators, a_denominators, b_numerators, b_denominators, order, 4), FRACTION_OK);
+    EXPECT_EQ(order[0], 1);
+    EXPECT_EQ(order[1], -1);
+    EXPECT_EQ(order[2], 0);
+    EXPECT_EQ(order[3], -1);
+    int32_t small_numerators[1] = {1};
+    int32_t small_denominators[1] = {-2};
+    int32_t small_other_numerators[1] = {-1};
+    int32_t small_other_denominators[1] = {3};
+    EXPECT_EQ(fraction_i32_compare(small_numerators, small_denominators, small_other_numerators, small_other_denominators, order, 1), FRACTION_OK);
+    EXPECT_EQ(order[0], -1);
+
+    int64_t numerators[3] = {6, 4, std::numeric_limits<int64_t>::min()};
+    int64_t denominators[3] = {-4, 8, -1};
+    EXPECT_EQ(fraction_i64_reduce(numerators, denominators, 2), FRACTION_OK);
+    EXPECT_EQ(numerators[0], -3);
+    EXPECT_EQ(denominators[0], 2);
+    EXPECT_EQ(numerators[1], 1);
+    EXPECT_EQ(denominators[1], 2);
+    EXPECT_EQ(fraction_i64_reduce(numerators + 2, denominators + 2, 1), FRACTION_OVERFLOW);
+    EXPECT_EQ(numerators[2], std::numeric_limits<int64_t>::min());
+    EXPECT_EQ(denominators[2], -1);
+
+    double approximations[2];
+    EXPECT_EQ(fraction_i64_to_double(numerators, denominators, approximations, 2), FRACTION_OK);
+    EXPECT_DOUBLE_EQ(approximations[0], -1.5);
+    EXPECT_DOUBLE_EQ(approximations[1], 0.5);
+
+    EXPECT_EQ(fraction_i64_reduce(nullptr, nullptr, 0), FRACTION_OK);
+    EXPECT_EQ(fraction_i64_to_double(nullptr, nullptr, nullptr, 0), FRACTION_OK);
+    EXPECT_EQ(fraction_i64_reduce(numerators, nullptr, 1), FRACTION_NULL_POINTER);
+    EXPECT_EQ(fraction_i32_compare(small_numerators, small_denominators, nullptr, small_other_denominators, order, 1), FRACTION_NULL_POINTER);
+    EXPECT_EQ(fraction_abi_version(), FRACTION_ABI_VERSION);
+}
+
@@ -0,0 +1,92 @@
+// Built as its own test binary: every translation unit must agree on FRACTION_TRACE,
+// so this file must not be linked with TestFraction.cpp or FractionC.cpp.
+#define FRACTION_TRACE
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <backend/cpp/FractionTrace.hpp>
+#include <backend/cpp/Fractions.hpp>
+#include <gtest/gtest.h>
+
+namespace Fraction{
+// test if the operators report to the active recorder and only to it
+TEST(FractionTraceTest, OperatorsRecord) {
+    std::string path = ::testing::TempDir() + "fraction_operator_trace_test.frtr";
+    Fraction<long int> f1(1, 2);
+    Fraction<long int> f2(-1, 3);
+    EXPECT_EQ((f1 + f2).getNumerator(), 1);  // no recorder active, not recorded
+    {
+        TraceRecorder<long int> recorder(path);
+        recorder.start();
+        Fraction<long int> sum = f1 + f2;
+        Fraction<long int> quotient = f1 / f2;
+        bool less = f2 < f1;
+        Fraction<long int> f3 = f1;
+        f3 *= f2;
+        EXPECT_EQ(sum.getNumerator(), 1);
+        EXPECT_EQ(quotient.getNumerator(), -3);
+        EXPECT_EQ(less, true);
+        recorder.stop();
+        f3 -= f2;  // after stop, not recorded
+    }
+    EXPECT_EQ((f1 - f2).getNumerator(), 5);  // after the recorder is gone, not recorded
+
+    std::vector<TraceRecord<long int>> records = readTrace<long int>(path);
+    ASSERT_EQ(records.size(), 4u);
+    EXPECT_EQ(records[0].operation, TraceOperation::Add);
+    EXPECT_EQ(records[0].lhs_numerator, 1);
+    EXPECT_EQ(records[0].lhs_denominator, 2);
+    EXPECT_EQ(records[0].rhs_numerator, -1);
+    EXPECT_EQ(records[0].rhs_denominator, 3);
+    EXPECT_EQ(records[0].result_numerator, 1);
+    EXPECT_EQ(records[0].result_denominator, 6);
+    EXPECT_EQ(records[1].operation, TraceOperation::Divide);
+    EXPECT_EQ(records[1].result_numerator, -3);
+    EXPECT_EQ(records[1].result_denominator, 2);
+    EXPECT_EQ(records[2].operation, TraceOperation::Less);
+    EXPECT_EQ(records[2].lhs_numerator, -1);
+    EXPECT_EQ(records[2].result_numerator, 1);
+    EXPECT_EQ(records[3].operation, TraceOperation::Multiply);
+    EXPECT_EQ(records[3].lhs_numerator, 1);
+    EXPECT_EQ(records[3].lhs_denominator, 2);
+    EXPECT_EQ(records[3].result_numerator, -1);
+    EXPECT_EQ(records[3].result_denominator, 6);
+
+    TraceReplayReport report = replayTrace(records);
+    EXPECT_EQ(report.operations, 4u);
+    EXPECT_EQ(report.mismatches, 0u);
+    std::remove(path.c_str());
+}
+
+// test if recorders can be stopped and destroyed while other threads keep running traced operations
+TEST(FractionTraceTest, RecorderLifetimeWithRunningThreads) {
+    std::string path = ::testing::TempDir() + "fraction_concurrent_trace_test.frtr";
+    std::atomic<bool> running{true};
+    std::vector<std::thread> workers;
+    for (int i = 0; i < 4; ++i) {
+        workers.emplace_back([&running, i] {
+            Fraction<long int> sum(0);
+            while (running.load())
+                sum = sum + Fraction<long int>(1, i + 2) - Fraction<long int>(1, i + 2);
+        });
+    }
+    for (int i = 0; i < 50; ++i) {
+        TraceRecorder<long int> recorder(path);
+        recorder.start();
+        std::this_thread::yield();
+    }
+    running.store(false);
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    std::vector<TraceRecord<long int>> records = readTrace<long int>(path);
+    EXPECT_EQ(replayTrace(records).mismatches, 0u);
+    std::remove(path.c_str());
+}
+
+}